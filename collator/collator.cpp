@@ -64,14 +64,18 @@ std::list<std::unique_ptr<Version>> GetVersions(
 
             if (sscanf(name.c_str(), "%u.%u", &major, &minor) == 2) {
                 const MemoryFile pic(picPath);
-                const MemoryFile spr(sprPath);
                 const MemoryFile dat(datPath);
 
+                /* Validation never draws anything, so there's no need to
+                 * decode any sprites. */
+                auto spr = std::make_shared<const MemoryFile>(sprPath);
+
                 result.push_back(std::make_unique<Version>(
                         VersionTriplet(major, minor, 0),
                         pic.Reader(),
-                        spr.Reader(),
-                        dat.Reader()));
+                        spr->Reader(),
+                        dat.Reader(),
+                        spr));
             }
         }
     }
@@ -106,7 +110,7 @@ static constexpr auto YMD(int year, int month, int day) {
 }
 
 std::optional<std::string> GuessVersion(
-        const std::list<Recordings::Recording::Frame> &frames) {
+        const std::vector<Recordings::Recording::Frame> &frames) {
     /* Versions with significant data or protocol changes that we've been able
      * to find data files for. This is just intended as a rough guide for later
      * analysis. */
@@ -154,12 +158,12 @@ std::optional<std::string> GuessVersion(
         }
 
         for (const auto &event : frame.Events) {
-            if (event->Kind() != Events::Type::StatusMessageReceived) {
+            if (event.Kind() != Events::Type::StatusMessageReceived) {
                 continue;
             }
 
             const auto &message =
-                    static_cast<Events::StatusMessageReceived &>(*event)
+                    static_cast<const Events::StatusMessageReceived &>(event)
                             .Message;
             int day, year;
             char month[4];
@@ -218,7 +222,7 @@ std::pair<Collation::RecordingFile, std::filesystem::path> ProcessRecording(
                 try {
                     for (const auto &frame : recording->Frames) {
                         for (const auto &event : frame.Events) {
-                            event->Update(state);
+                            event.Update(state);
                         }
                     }
 
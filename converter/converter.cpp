@@ -42,7 +42,9 @@ int main(int argc, char **argv) {
             .EndTime = std::chrono::milliseconds::max(),
 
             .FrameRate = 25,
-            .FrameSkip = 1};
+            .FrameSkip = 1,
+
+            .Benchmark = Exporter::Benchmark::None};
 
     auto paths = CLI::Process(
             argc,
@@ -52,6 +54,22 @@ int main(int argc, char **argv) {
             "tibiarc-converter 0.3",
             {"data_folder", "input_path", "output_path"},
             {
+                    {"benchmark",
+                     {"report the time spent rendering once done, through "
+                      "the 'specialized' renderer for the preset matching "
+                      "the render options (if any), or the 'generic' one",
+                      {"renderer"},
+                      [&](const CLI::Range &args) {
+                          if (args[0] == "specialized") {
+                              settings.Benchmark =
+                                      Exporter::Benchmark::Specialized;
+                          } else if (args[0] == "generic") {
+                              settings.Benchmark = Exporter::Benchmark::Generic;
+                          } else {
+                              throw "benchmark must be 'specialized' or "
+                                    "'generic'";
+                          }
+                      }}},
                     {"end-time",
                      {"when to stop encoding, in milliseconds relative to "
                       "start",
@@ -221,6 +239,31 @@ int main(int argc, char **argv) {
                           settings.OutputFormat = args[0];
                       }}},
 
+                    {"render-preset",
+                     {"sets all 'skip-rendering' options at once, to those of "
+                      "'default', 'map-only', 'no-text', or 'minimap'",
+                      {"preset"},
+                      [&](const CLI::Range &args) {
+                          const auto &preset = args[0];
+
+                          if (preset == "default") {
+                              Renderer::ApplyPreset(Renderer::Preset::Default,
+                                                    settings.RenderOptions);
+                          } else if (preset == "map-only") {
+                              Renderer::ApplyPreset(Renderer::Preset::MapOnly,
+                                                    settings.RenderOptions);
+                          } else if (preset == "no-text") {
+                              Renderer::ApplyPreset(Renderer::Preset::NoText,
+                                                    settings.RenderOptions);
+                          } else if (preset == "minimap") {
+                              Renderer::ApplyPreset(Renderer::Preset::Minimap,
+                                                    settings.RenderOptions);
+                          } else {
+                              throw "render-preset must be 'default', "
+                                    "'map-only', 'no-text', or 'minimap'";
+                          }
+                      }}},
+
                     {"skip-rendering-creature-health-bars",
                      {"removes health bars above creatures",
                       {},
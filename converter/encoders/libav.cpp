@@ -226,17 +226,10 @@ void LibAV::WriteFrame(const Canvas &canvas) {
         throw EncodeError();
     }
 
-    result = av_image_fill_arrays(TranscodeFrame->data,
-                                  TranscodeFrame->linesize,
-                                  canvas.Buffer,
-                                  AV_PIX_FMT_RGBA,
-                                  canvas.Width,
-                                  canvas.Height,
-                                  LEVEL1_DCACHE_LINESIZE);
-
-    if (result < 0) {
-        throw EncodeError();
-    }
+    /* Read straight from the canvas, whose stride need not match what
+     * av_image_fill_arrays would have picked for us. */
+    TranscodeFrame->data[0] = canvas.Buffer;
+    TranscodeFrame->linesize[0] = canvas.Stride;
 
     result = sws_scale(Transcoder.get(),
                        (const uint8_t *const *)TranscodeFrame->data,
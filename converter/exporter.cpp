@@ -82,110 +82,6 @@ static void DrawInterface(const Renderer::Options &options,
     }
 }
 
-static void CopyRect(Canvas &canvas,
-                     int dX,
-                     int dY,
-                     const Canvas &from,
-                     int sX,
-                     int sY,
-                     int width,
-                     int height) {
-    int lineOffset, lineWidth;
-
-    if (!((dX < canvas.Width) && (dY < canvas.Height) && (dX + width >= 0) &&
-          (dY + height >= 0))) {
-        return;
-    }
-
-    height = std::min(std::min(height, canvas.Height - dY), from.Height - sY);
-
-    lineWidth = std::min(std::min(width, from.Width - sX), canvas.Width - dX);
-    lineOffset = std::max(std::max(-sY, -dY), 0);
-
-    for (; lineOffset < height; lineOffset++) {
-        memcpy(&canvas.GetPixel(dX, dY + lineOffset),
-               &from.GetPixel(sX, sY + lineOffset),
-               lineWidth * sizeof(Pixel));
-    }
-}
-
-/* FIXME: Naive and hysterically slow bilinear rescaler, we'll move this to
- * libswscale once the redesigned player has been merged and we can chuck
- * SDL2, leaving only the libav backend; having to support the two in a common
- * API is too annoying at the moment. */
-static void RescaleClone(Canvas &canvas,
-                         int leftX,
-                         int topY,
-                         int rightX,
-                         int bottomY,
-                         const Canvas &from) {
-    float scaleFactorX, scaleFactorY;
-    int width, height;
-
-    width = rightX - leftX;
-    height = bottomY - topY;
-    Assert(width >= 0 && height >= 0);
-
-    scaleFactorX = (float)width / (float)from.Width;
-    scaleFactorY = (float)height / (float)from.Height;
-
-    if (scaleFactorX == 1 && scaleFactorY == 1) {
-        /* Hacky fast path for when we don't need rescaling, speeds up testing
-         * quite a lot. */
-        CopyRect(canvas, leftX, topY, from, 0, 0, from.Width, from.Height);
-        return;
-    }
-
-#ifdef _OPENMP
-#    pragma omp parallel for
-#endif
-    for (int toY = 0; toY < height; toY++) {
-        const int fromY0 = std::min(int(toY / scaleFactorY), from.Height - 1);
-        const int fromY1 = std::min(fromY0 + 1, from.Height - 1);
-        const float subOffsY = (toY / scaleFactorY) - fromY0;
-
-        for (int toX = 0; toX < width; toX++) {
-            const int fromX0 =
-                    std::min(int(toX / scaleFactorX), from.Width - 1);
-            const int fromX1 = std::min(fromX0 + 1, from.Width - 1);
-            const float subOffsX = (toX / scaleFactorX) - fromX0;
-
-            const Pixel srcPixels[4] = {from.GetPixel(fromX0, fromY0),
-                                        from.GetPixel(fromX1, fromY0),
-                                        from.GetPixel(fromX0, fromY1),
-                                        from.GetPixel(fromX1, fromY1)};
-            Pixel &dstPixel = canvas.GetPixel(toX + leftX, toY + topY);
-
-            float outRed, outGreen, outBlue, outAlpha;
-
-            outRed = srcPixels[0].Red * (1 - subOffsX) * (1 - subOffsY);
-            outGreen = srcPixels[0].Green * (1 - subOffsX) * (1 - subOffsY);
-            outBlue = srcPixels[0].Blue * (1 - subOffsX) * (1 - subOffsY);
-            outAlpha = srcPixels[0].Alpha * (1 - subOffsX) * (1 - subOffsY);
-
-            outRed += srcPixels[1].Red * (subOffsX) * (1 - subOffsY);
-            outGreen += srcPixels[1].Green * (subOffsX) * (1 - subOffsY);
-            outBlue += srcPixels[1].Blue * (subOffsX) * (1 - subOffsY);
-            outAlpha += srcPixels[1].Alpha * (subOffsX) * (1 - subOffsY);
-
-            outRed += srcPixels[2].Red * (1 - subOffsX) * (subOffsY);
-            outGreen += srcPixels[2].Green * (1 - subOffsX) * (subOffsY);
-            outBlue += srcPixels[2].Blue * (1 - subOffsX) * (subOffsY);
-            outAlpha += srcPixels[2].Alpha * (1 - subOffsX) * (subOffsY);
-
-            outRed += srcPixels[3].Red * (subOffsX) * (subOffsY);
-            outGreen += srcPixels[3].Green * (subOffsX) * (subOffsY);
-            outBlue += srcPixels[3].Blue * (subOffsX) * (subOffsY);
-            outAlpha += srcPixels[3].Alpha * (subOffsX) * (subOffsY);
-
-            dstPixel.Red = (uint8_t)(outRed + 0.5);
-            dstPixel.Green = (uint8_t)(outGreen + 0.5);
-            dstPixel.Blue = (uint8_t)(outBlue + 0.5);
-            dstPixel.Alpha = (uint8_t)(outAlpha + 0.5);
-        }
-    }
-}
-
 static void ConvertVideo(
         const Settings &settings,
         const std::unique_ptr<Recordings::Recording> &recording,
@@ -227,6 +123,43 @@ static void ConvertVideo(
     auto overlaySlice =
             outputCanvas.Slice(viewLeftX, viewTopY, viewRightX, viewBottomY);
 
+    Renderer::ViewState mapView;
+    TextRenderer::Cache overlayTexts;
+
+    /* The background is only visible around the map view and beneath the
+     * sidebar, neither of which are drawn over by anything else. Draw it once
+     * and keep a copy of the part beneath the sidebar, so that the sidebar
+     * can be redrawn by itself whenever its contents change.
+     *
+     * Without the sidebar, the interface is drawn on top of the map view and
+     * everything has to be redrawn on every frame. */
+    const bool drawSidebar = !renderOptions.SkipRenderingInventory;
+    Renderer::InterfaceState sidebarState;
+    Canvas sidebarBackground(SIDEBAR_WIDTH, outputCanvas.Height);
+
+    if (drawSidebar) {
+        Renderer::DrawClientBackground(gamestate,
+                                       outputCanvas,
+                                       0,
+                                       0,
+                                       outputCanvas.Width,
+                                       outputCanvas.Height);
+        sidebarBackground.Blit(outputCanvas,
+                               outputCanvas.Width - SIDEBAR_WIDTH,
+                               0,
+                               0,
+                               0,
+                               SIDEBAR_WIDTH,
+                               outputCanvas.Height);
+    }
+
+    /* Time spent in the renderer proper, see Settings::Benchmark. */
+    std::chrono::steady_clock::duration renderTime(0);
+    uint32_t renderedFrames = 0;
+
+    /* Sprites blitted onto the map, summed over all frames. */
+    Canvas::BlitStatistics mapBlits{};
+
     /* Clip start/end to recording bounds, allowing another second in case of
      * an abrupt end to the recording. */
     startTime = std::min(startTime, recording->Runtime);
@@ -237,17 +170,57 @@ static void ConvertVideo(
     /* Fast-forward until the game state is sufficiently initialized. */
     while (!gamestate.Creatures.contains(gamestate.Player.Id) &&
            currentFrame != recording->Frames.cend()) {
-        for (auto &event : currentFrame->Events) {
-            event->Update(gamestate);
+        for (const auto &event : currentFrame->Events) {
+            event.Update(gamestate);
         }
         currentFrame = std::next(currentFrame);
     }
 
+    /* Skip ahead to the start time without stepping through every video frame
+     * before it, applying each recorded frame at the same tick as the loop
+     * below would have. */
+    if (startTime > frameTimestamp) {
+        const auto lastSkipped = static_cast<uint32_t>(
+                (startTime.count() * frameRate + 999) / 1000 - 1);
+
+        while (frameTimestamp <= endTime) {
+            while (currentFrame != recording->Frames.cend() &&
+                   currentFrame->Timestamp <= frameTimestamp) {
+                for (const auto &event : currentFrame->Events) {
+                    event.Update(gamestate);
+                }
+
+                currentFrame = std::next(currentFrame);
+            }
+
+            /* The first video frame after the next recorded one. */
+            const auto limit = currentFrame != recording->Frames.cend()
+                                       ? std::min(currentFrame->Timestamp,
+                                                  endTime)
+                                       : endTime;
+            const auto nextNumber = std::max(
+                    frameNumber + 1,
+                    static_cast<uint32_t>(
+                            ((limit.count() + 1) * frameRate + 999) / 1000));
+
+            if (nextNumber > lastSkipped) {
+                break;
+            }
+
+            frameNumber = nextNumber;
+            frameTimestamp =
+                    std::chrono::milliseconds((frameNumber * 1000) / frameRate);
+            gamestate.CurrentTick = frameTimestamp.count();
+        }
+
+        frameNumber = std::max(frameNumber, lastSkipped);
+    }
+
     while (frameTimestamp <= endTime) {
         while (currentFrame != recording->Frames.cend() &&
                currentFrame->Timestamp <= frameTimestamp) {
             for (const auto &event : currentFrame->Events) {
-                event->Update(gamestate);
+                event.Update(gamestate);
             }
 
             currentFrame = std::next(currentFrame);
@@ -265,35 +238,75 @@ static void ConvertVideo(
                 continue;
             }
 
-            /* Wipe the background in the same manner Tibia does it, leaving
-             * empty spots on the map black. */
-            mapCanvas.DrawRectangle(Pixel(0, 0, 0),
-                                    0,
-                                    0,
-                                    Renderer::NativeResolutionX,
-                                    Renderer::NativeResolutionY);
-
-            Renderer::DrawClientBackground(gamestate,
-                                           outputCanvas,
-                                           0,
-                                           0,
-                                           outputCanvas.Width,
-                                           outputCanvas.Height);
-
-            Renderer::DrawGamestate(renderOptions, gamestate, mapCanvas);
-
-            RescaleClone(outputCanvas,
-                         viewLeftX,
-                         viewTopY,
-                         viewRightX,
-                         viewBottomY,
-                         mapCanvas);
+            if (!drawSidebar) {
+                Renderer::DrawClientBackground(gamestate,
+                                               outputCanvas,
+                                               0,
+                                               0,
+                                               outputCanvas.Width,
+                                               outputCanvas.Height);
+            }
+
+            mapCanvas.Blits = {};
+
+            auto renderStart = std::chrono::steady_clock::now();
+
+            /* The map canvas is left as-is between frames, letting the
+             * renderer redraw only what has changed. */
+            if (settings.Benchmark == Benchmark::Generic) {
+                Renderer::DrawGamestate<Renderer::Preset::Custom>(renderOptions,
+                                                                  gamestate,
+                                                                  mapView,
+                                                                  mapCanvas);
+            } else {
+                Renderer::DrawGamestate(renderOptions,
+                                        gamestate,
+                                        mapView,
+                                        mapCanvas);
+            }
+
+            renderTime += std::chrono::steady_clock::now() - renderStart;
+            mapBlits += mapCanvas.Blits;
+
+            outputCanvas.Scale(mapCanvas,
+                               viewLeftX,
+                               viewTopY,
+                               viewRightX - viewLeftX,
+                               viewBottomY - viewTopY);
 
             /* FIXME: C++ migration. */
             gamestate.Messages.Prune(gamestate.CurrentTick);
 
-            Renderer::DrawOverlay(renderOptions, gamestate, overlaySlice);
-            DrawInterface(renderOptions, gamestate, outputCanvas);
+            renderStart = std::chrono::steady_clock::now();
+
+            if (settings.Benchmark == Benchmark::Generic) {
+                Renderer::DrawOverlay<Renderer::Preset::Custom>(renderOptions,
+                                                                gamestate,
+                                                                overlayTexts,
+                                                                overlaySlice);
+            } else {
+                Renderer::DrawOverlay(renderOptions,
+                                      gamestate,
+                                      overlayTexts,
+                                      overlaySlice);
+            }
+
+            renderTime += std::chrono::steady_clock::now() - renderStart;
+            renderedFrames++;
+
+            if (!drawSidebar) {
+                DrawInterface(renderOptions, gamestate, outputCanvas);
+            } else if (Renderer::UpdateInterfaceState(gamestate,
+                                                      sidebarState)) {
+                outputCanvas.Blit(sidebarBackground,
+                                  0,
+                                  0,
+                                  outputCanvas.Width - SIDEBAR_WIDTH,
+                                  0,
+                                  SIDEBAR_WIDTH,
+                                  outputCanvas.Height);
+                DrawInterface(renderOptions, gamestate, outputCanvas);
+            }
 
             encoder.WriteFrame(outputCanvas);
 
@@ -312,6 +325,40 @@ static void ConvertVideo(
     }
 
     encoder.Flush();
+
+    if (settings.Benchmark != Benchmark::None && renderedFrames > 0) {
+        const std::chrono::duration<double, std::micro> total = renderTime;
+
+        std::cout << std::format("benchmark: rendered {} frames with the {} "
+                                 "renderer in {:.0f} ms, {:.1f} us per frame",
+                                 renderedFrames,
+                                 settings.Benchmark == Benchmark::Generic
+                                         ? "generic"
+                                         : "specialized",
+                                 total.count() / 1000,
+                                 total.count() / renderedFrames)
+                  << std::endl;
+
+        std::cout << std::format("benchmark: blitted {:.1f} empty, {:.1f} "
+                                 "opaque, and {:.1f} masked sprites onto the "
+                                 "map per frame",
+                                 mapBlits.Empty / double(renderedFrames),
+                                 mapBlits.Opaque / double(renderedFrames),
+                                 mapBlits.Masked / double(renderedFrames))
+                  << std::endl;
+
+        const auto tints = gamestate.Version.TintedOutfits.GetStatistics();
+
+        std::cout << std::format("benchmark: tinted outfit cache had {} hits "
+                                 "and {} misses, evicted {} entries, and "
+                                 "holds {} entries in {} KiB",
+                                 tints.Hits,
+                                 tints.Misses,
+                                 tints.Evictions,
+                                 tints.Entries,
+                                 tints.Size >> 10)
+                  << std::endl;
+    }
 }
 
 static auto Open(const Settings &settings,
@@ -343,13 +390,16 @@ static auto Open(const Settings &settings,
     }
 
     const MemoryFile pictures(dataFolder / "Tibia.pic");
-    const MemoryFile sprites(dataFolder / "Tibia.spr");
+    /* Only the sprites we draw need to be decoded, keep the file mapped for
+     * as long as the version lives. */
+    auto sprites = std::make_shared<const MemoryFile>(dataFolder / "Tibia.spr");
     const MemoryFile types(dataFolder / "Tibia.dat");
 
     auto version = std::make_unique<Version>(desiredVersion,
                                              pictures.Reader(),
-                                             sprites.Reader(),
-                                             types.Reader());
+                                             sprites->Reader(),
+                                             types.Reader(),
+                                             sprites);
     auto [recording, partial] = Recordings::Read(inputFormat,
                                                  reader,
                                                  *version,
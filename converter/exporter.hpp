@@ -31,6 +31,11 @@
 
 namespace trc {
 namespace Exporter {
+/* Whether to report the time spent rendering once done, and whether to go
+ * through the renderer specialized for the preset matching the render
+ * options (if any) or the generic one that tests the options as it goes. */
+enum class Benchmark { None, Specialized, Generic };
+
 struct Settings {
     struct Renderer::Options RenderOptions;
 
@@ -48,6 +53,8 @@ struct Settings {
     int FrameRate;
     int FrameSkip;
 
+    Exporter::Benchmark Benchmark;
+
     VersionTriplet DesiredTibiaVersion;
 };
 
@@ -140,7 +140,7 @@ static std::optional<RecordingMetadata> ReadMetadata(
 
             for (const auto &frame : parsed->Frames) {
                 for (const auto &event : frame.Events) {
-                    event->Update(state);
+                    event.Update(state);
                 }
             }
 
@@ -327,15 +327,17 @@ std::pair<size_t, Database::Future<size_t>> Database::LoadData() {
                                              std::format("{}", signatures.Dat));
                         const MemoryFile pic(PicDirectory /
                                              std::format("{}", signatures.Pic));
-                        const MemoryFile spr(SprDirectory /
-                                             std::format("{}", signatures.Spr));
+                        auto spr = std::make_shared<const MemoryFile>(
+                                SprDirectory /
+                                std::format("{}", signatures.Spr));
 
                         /* Note that we cannot use `std::unique_ptr` since
                          * `QtConcurrent` requires copyable values. */
                         return std::make_shared<Version>(triplet,
                                                          pic.Reader(),
-                                                         spr.Reader(),
-                                                         dat.Reader());
+                                                         spr->Reader(),
+                                                         dat.Reader(),
+                                                         spr);
                     },
                     [this](size_t &loaded,
                            const std::shared_ptr<Version> &version) {
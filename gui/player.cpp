@@ -171,9 +171,14 @@ Player::~Player() {
 void Player::ResetInterface() {
     ChatTabs.clear();
 
+    /* Leave the chat logs themselves alone, they're cleared as they're
+     * opened again. */
     ChatChannels.clear();
     PrivateChannels.clear();
+    OpenedChats = 0;
+
     DefaultChannel.clear();
+    NPCChannel.clear();
 
     AddChatTab(DefaultChannel, "Default");
 
@@ -182,6 +187,48 @@ void Player::ResetInterface() {
     }
 }
 
+void Player::SaveChat(std::chrono::milliseconds timestamp) {
+    auto &state = ChatKeyframes[timestamp];
+
+    state.Tabs.clear();
+
+    for (int index = 0; index < ChatTabs.count(); index++) {
+        auto &editor = static_cast<QTextEdit &>(*ChatTabs.widget(index));
+
+        state.Tabs.push_back({&editor,
+                              ChatTabs.tabText(index),
+                              editor.document()->blockCount()});
+    }
+
+    state.Channels = ChatChannels;
+    state.Conversations = PrivateChannels;
+    state.Opened = OpenedChats;
+}
+
+void Player::RestoreChat(const ChatState &state) {
+    ChatTabs.clear();
+
+    for (const auto &tab : state.Tabs) {
+        auto &document = *tab.Editor->document();
+
+        /* Every message is followed by an empty block, which is kept. */
+        if (document.blockCount() > tab.Blocks) {
+            QTextCursor cursor(&document);
+
+            cursor.setPosition(document.findBlockByNumber(tab.Blocks - 1)
+                                       .position());
+            cursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
+            cursor.removeSelectedText();
+        }
+
+        ChatTabs.addTab(tab.Editor, tab.Name);
+    }
+
+    ChatChannels = state.Channels;
+    PrivateChannels = state.Conversations;
+    OpenedChats = state.Opened;
+}
+
 void Player::RenderFrame(size_t ticket) {
     if (FrameTicket != ticket) {
         return;
@@ -225,40 +272,40 @@ void Player::RenderViewport() {
     ViewportScene.clear();
 
     {
-        Canvas canvas(Renderer::NativeResolutionX,
-                      Renderer::NativeResolutionY,
-                      Canvas::Type::External);
-        QImage image(Renderer::NativeResolutionX,
-                     Renderer::NativeResolutionY,
-                     QImage::Format::Format_RGBA8888);
-        canvas.Buffer = image.scanLine(0);
-        canvas.Stride = image.bytesPerLine();
-
-        /* Wipe the background in the same manner Tibia does it, leaving empty
-         * spots on the map black. */
-        canvas.DrawRectangle(Pixel(0, 0, 0),
-                             0,
-                             0,
-                             Renderer::NativeResolutionX,
-                             Renderer::NativeResolutionY);
-        Renderer::DrawGamestate(options, *Gamestate, canvas);
-
-        auto item = ViewportScene.addPixmap(QPixmap::fromImage(image));
+        if (MapImage.isNull()) {
+            MapImage = QImage(Renderer::NativeResolutionX,
+                              Renderer::NativeResolutionY,
+                              QImage::Format::Format_RGBA8888);
+        }
+
+        /* The renderer falls back to a full redraw if the buffer moves, so
+         * we must never let the image detach. */
+        Canvas canvas(MapImage.width(),
+                      MapImage.height(),
+                      MapImage.bytesPerLine(),
+                      MapImage.scanLine(0));
+
+        Renderer::DrawGamestate(options, *Gamestate, MapView, canvas);
+
+        /* `QPixmap::fromImage` may share the buffer with the pixmap, which
+         * would detach the image the next time we write to it. Hand it a
+         * copy instead, which is far cheaper than redrawing the map. */
+        auto item =
+                ViewportScene.addPixmap(QPixmap::fromImage(MapImage.copy()));
         item->setScale(scale);
     }
 
     {
-        Canvas canvas(Renderer::NativeResolutionX * scale,
-                      Renderer::NativeResolutionY * scale,
-                      Canvas::Type::External);
         QImage image(Renderer::NativeResolutionX * scale,
                      Renderer::NativeResolutionY * scale,
                      QImage::Format::Format_RGBA8888);
-        canvas.Buffer = image.scanLine(0);
-        canvas.Stride = image.bytesPerLine();
+        Canvas canvas(image.width(),
+                      image.height(),
+                      image.bytesPerLine(),
+                      image.scanLine(0));
 
         canvas.Wipe();
-        Renderer::DrawOverlay(options, *Gamestate, canvas);
+        Renderer::DrawOverlay(options, *Gamestate, OverlayTexts, canvas);
 
         ViewportScene.addPixmap(QPixmap::fromImage(image));
     }
@@ -283,6 +330,13 @@ void Player::RenderSidebar() {
     auto &state = *Gamestate;
     int baseY = 0;
 
+    /* Keep the scene as-is until something shown in it changes. */
+    if (!Renderer::UpdateInterfaceState(state, SidebarState) &&
+        maxWidth == SidebarWidth) {
+        return;
+    }
+
+    SidebarWidth = maxWidth;
     SidebarScene.clear();
 
     {
@@ -292,12 +346,13 @@ void Player::RenderSidebar() {
                                     ? Renderer::MeasureIconBarHeight(state)
                                     : 0);
 
-        Canvas canvas(maxWidth, height, Canvas::Type::External);
         QImage image(maxWidth, height, QImage::Format::Format_RGBA8888);
         int offsetX = 0, offsetY = 0;
 
-        canvas.Buffer = image.scanLine(0);
-        canvas.Stride = image.bytesPerLine();
+        Canvas canvas(image.width(),
+                      image.height(),
+                      image.bytesPerLine(),
+                      image.scanLine(0));
         canvas.Wipe();
 
         Renderer::DrawStatusBars(state, canvas, offsetX, offsetY);
@@ -322,11 +377,12 @@ void Player::RenderSidebar() {
                                                       maxWidth);
         int offsetX = 0, offsetY = 0;
 
-        Canvas canvas(maxWidth, height, Canvas::Type::External);
         QImage image(maxWidth, height, QImage::Format::Format_RGBA8888);
 
-        canvas.Buffer = image.scanLine(0);
-        canvas.Stride = image.bytesPerLine();
+        Canvas canvas(image.width(),
+                      image.height(),
+                      image.bytesPerLine(),
+                      image.scanLine(0));
         canvas.Wipe();
 
         Renderer::DrawContainer(state,
@@ -348,11 +404,12 @@ void Player::RenderSidebar() {
         int height = Renderer::MeasureSkillsHeight(state);
         int offsetX = 0, offsetY = 0;
 
-        Canvas canvas(maxWidth, height, Canvas::Type::External);
         QImage image(maxWidth, height, QImage::Format::Format_RGBA8888);
 
-        canvas.Buffer = image.scanLine(0);
-        canvas.Stride = image.bytesPerLine();
+        Canvas canvas(image.width(),
+                      image.height(),
+                      image.bytesPerLine(),
+                      image.scanLine(0));
         canvas.Wipe();
 
         Renderer::DrawSkills(state, canvas, maxWidth - 24, offsetX, offsetY);
@@ -369,14 +426,15 @@ void Player::RenderSidebar() {
 void Player::UpdateBackground() {
     const auto &background = Gamestate->Version.Icons.ClientBackground;
 
-    Canvas canvas(background.Width, background.Height, Canvas::Type::External);
     QImage image(background.Width,
                  background.Height,
                  QImage::Format::Format_RGBA8888);
     int offsetX = 0, offsetY = 0;
 
-    canvas.Buffer = image.scanLine(0);
-    canvas.Stride = image.bytesPerLine();
+    Canvas canvas(image.width(),
+                  image.height(),
+                  image.bytesPerLine(),
+                  image.scanLine(0));
     canvas.Wipe();
 
     Renderer::DrawClientBackground(*Gamestate,
@@ -398,21 +456,35 @@ void Player::AddChatTab(QTextEdit &editor, const std::string &name) {
     ChatTabs.addTab(&editor, name.c_str());
 }
 
+QTextEdit &Player::OpenChatTab(const std::string &name) {
+    if (OpenedChats == ChatLogs.size()) {
+        ChatLogs.emplace_back(&ChatTabs);
+    }
+
+    /* Chats we've seen before are opened again in the same order when
+     * playing past them once more, so we reuse them rather than pile up new
+     * ones on every backward seek. */
+    auto &editor = ChatLogs[OpenedChats++];
+
+    editor.clear();
+    AddChatTab(editor, name);
+
+    return editor;
+}
+
 void Player::ProcessEvent([[maybe_unused]] std::chrono::milliseconds timestamp,
                           const Events::PrivateConversationOpened &event) {
-    auto [it, added] = PrivateChannels.try_emplace(event.Name, &ChatTabs);
+    std::string name(event.Name);
 
-    if (added) {
-        AddChatTab(it->second, event.Name.c_str());
+    if (!PrivateChannels.contains(name)) {
+        PrivateChannels.emplace(name, &OpenChatTab(name));
     }
 }
 
 void Player::ProcessEvent([[maybe_unused]] std::chrono::milliseconds timestamp,
                           const Events::ChannelOpened &event) {
-    auto [it, added] = ChatChannels.try_emplace(event.Id, &ChatTabs);
-
-    if (added) {
-        AddChatTab(it->second, event.Name.c_str());
+    if (!ChatChannels.contains(event.Id)) {
+        ChatChannels.emplace(event.Id, &OpenChatTab(event.Name.c_str()));
     }
 }
 
@@ -421,7 +493,7 @@ void Player::ProcessEvent([[maybe_unused]] std::chrono::milliseconds timestamp,
     auto it = ChatChannels.find(event.Id);
 
     if (it != ChatChannels.end()) {
-        auto index = ChatTabs.indexOf(&it->second);
+        auto index = ChatTabs.indexOf(it->second);
         ChatTabs.removeTab(index);
         ChatChannels.erase(it);
     }
@@ -489,7 +561,7 @@ void Player::ProcessEvent(std::chrono::milliseconds timestamp,
     auto it = ChatChannels.find(event.ChannelId);
 
     if (it != ChatChannels.end()) {
-        AddChatMessage(it->second, timestamp, event);
+        AddChatMessage(*it->second, timestamp, event);
     }
 }
 
@@ -519,13 +591,14 @@ void Player::ProcessEvent(std::chrono::milliseconds timestamp,
         return;
     }
 
-    auto [it, added] = PrivateChannels.try_emplace(event.AuthorName, &ChatTabs);
+    std::string name(event.AuthorName);
+    auto it = PrivateChannels.find(name);
 
-    if (added) {
-        AddChatTab(it->second, event.AuthorName);
+    if (it == PrivateChannels.end()) {
+        it = PrivateChannels.emplace(name, &OpenChatTab(name)).first;
     }
 
-    AddChatMessage(it->second, timestamp, event);
+    AddChatMessage(*it->second, timestamp, event);
 }
 
 void Player::ProcessEvent(
@@ -598,20 +671,27 @@ void Player::ProcessEvents(std::chrono::milliseconds until) {
     if (until < std::chrono::milliseconds(Gamestate->CurrentTick)) {
         BaseTick = until;
 
-        /* The user has selected a time in the past. Since we lack keyframes,
-         * reset everything and start from the beginning. */
-        ResetInterface();
-
-        Needle = Recording->Frames.cbegin();
-
+        /* The user has selected a time in the past, start over from the
+         * nearest keyframe before it, or the beginning if there is none. */
         Gamestate->Reset();
         Gamestate->CurrentTick = until.count();
 
+        if (auto keyframe = Keyframes.Find(until)) {
+            Gamestate->Restore(keyframe->State);
+            RestoreChat(ChatKeyframes.at(keyframe->Timestamp));
+
+            Needle = keyframe->Next;
+        } else {
+            ResetInterface();
+
+            Needle = Recording->Frames.cbegin();
+        }
+
         /* Fast-forward until the game state is sufficiently initialized. */
         while (!Gamestate->Creatures.contains(Gamestate->Player.Id) &&
                Needle != Recording->Frames.cend()) {
-            for (auto &event : Needle->Events) {
-                ProcessEvent(Needle->Timestamp, *event);
+            for (const auto &event : Needle->Events) {
+                ProcessEvent(Needle->Timestamp, event);
             }
 
             Needle = std::next(Needle);
@@ -619,11 +699,15 @@ void Player::ProcessEvents(std::chrono::milliseconds until) {
     }
 
     while (Needle != Recording->Frames.cend() && Needle->Timestamp <= until) {
-        for (auto &event : Needle->Events) {
-            ProcessEvent(Needle->Timestamp, *event);
+        for (const auto &event : Needle->Events) {
+            ProcessEvent(Needle->Timestamp, event);
         }
 
         Needle = std::next(Needle);
+
+        if (Keyframes.Record(*Recording, Needle, *Gamestate)) {
+            SaveChat(std::prev(Needle)->Timestamp);
+        }
     }
 
     Gamestate->CurrentTick = until.count();
@@ -633,6 +717,17 @@ void Player::Open(const Version &version,
                   std::unique_ptr<Recordings::Recording> &&recording) {
     Recording = std::move(recording);
     Gamestate = std::make_unique<trc::Gamestate>(version);
+    MapView = Renderer::ViewState();
+    OverlayTexts.Clear();
+    SidebarState = Renderer::InterfaceState();
+    Keyframes.Clear();
+
+    /* The chat logs of the previous recording go out with its keyframes. */
+    ChatTabs.clear();
+    ChatChannels.clear();
+    PrivateChannels.clear();
+    ChatKeyframes.clear();
+    ChatLogs.clear();
 
     UpdateBackground();
 
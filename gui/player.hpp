@@ -24,17 +24,21 @@
 #include "recordings.hpp"
 #include "gamestate.hpp"
 #include "events.hpp"
+#include "renderer.hpp"
 
 #include "mediacontrols.hpp"
 
 #include <string>
 #include <chrono>
+#include <deque>
 #include <map>
+#include <vector>
 
 #include <QFrame>
 #include <QGraphicsView>
 #include <QGridLayout>
 #include <QHBoxLayout>
+#include <QImage>
 #include <QSplitter>
 #include <QTabWidget>
 #include <QTextEdit>
@@ -61,16 +65,57 @@ class Player : public QGraphicsView {
     QTextEdit NPCChannel;
     QGraphicsView Sidebar;
 
-    std::map<uint32_t, QTextEdit> ChatChannels;
-    std::map<std::string, QTextEdit> PrivateChannels;
+    /* Every chat opened since the recording was loaded, in the order they
+     * were opened. Closed chats are kept as keyframes may refer to them, and
+     * the rest are reused when playback reaches them again after seeking
+     * backwards. */
+    std::deque<QTextEdit> ChatLogs;
+    size_t OpenedChats = 0;
+
+    std::map<uint32_t, QTextEdit *> ChatChannels;
+    std::map<std::string, QTextEdit *> PrivateChannels;
+
+    /* The chat tabs aren't part of the game state, so we note how far along
+     * each of them was whenever a keyframe is taken, and cut them back to
+     * that when seeking to it.
+     *
+     * States are left behind when the keyframe index thins itself out, but
+     * they're small enough that it doesn't matter. */
+    struct ChatState {
+        struct Tab {
+            QTextEdit *Editor;
+            QString Name;
+            int Blocks;
+        };
+
+        std::vector<Tab> Tabs;
+        std::map<uint32_t, QTextEdit *> Channels;
+        std::map<std::string, QTextEdit *> Conversations;
+        size_t Opened;
+    };
+
+    std::map<std::chrono::milliseconds, ChatState> ChatKeyframes;
 
     void ResetInterface();
+    void SaveChat(std::chrono::milliseconds timestamp);
+    void RestoreChat(const ChatState &state);
 
     /* Rendering */
     QGraphicsScene BackgroundScene;
     QGraphicsScene SidebarScene;
     QGraphicsScene ViewportScene;
 
+    /* The map is kept between frames so that only what has changed needs to
+     * be redrawn. */
+    QImage MapImage;
+    Renderer::ViewState MapView;
+    /* Names and messages tend to stay the same from one frame to the next,
+     * so we keep them around pre-rendered. */
+    TextRenderer::Cache OverlayTexts;
+    /* The sidebar is only redrawn when its contents or width change. */
+    Renderer::InterfaceState SidebarState;
+    int SidebarWidth = 0;
+
     std::chrono::steady_clock::time_point LastFrameAt;
 
     /* Ticket value for render/update loops; if a timer fires and its ticket
@@ -89,6 +134,7 @@ class Player : public QGraphicsView {
 
     /* Event handling */
     void AddChatTab(QTextEdit &editor, const std::string &name);
+    QTextEdit &OpenChatTab(const std::string &name);
     void AddChatMessage(QTextEdit &editor,
                         std::chrono::milliseconds timestamp,
                         const Events::CreatureSpoke &event);
@@ -115,7 +161,11 @@ class Player : public QGraphicsView {
     /* Playback */
     std::unique_ptr<trc::Gamestate> Gamestate;
     std::unique_ptr<Recordings::Recording> Recording;
-    std::list<Recordings::Recording::Frame>::const_iterator Needle;
+    std::vector<Recordings::Recording::Frame>::const_iterator Needle;
+
+    /* Keyframes are taken every 30 seconds of the recording as it plays,
+     * spreading out as needed to stay within 256MB. */
+    Recordings::KeyframeIndex Keyframes{std::chrono::seconds(30), 256 << 20};
 
     std::chrono::milliseconds BaseTick;
     std::chrono::steady_clock::time_point LastUpdate;
@@ -0,0 +1,726 @@
+/*
+ * Copyright 2025 "John Högberg"
+ *
+ * This file is part of tibiarc.
+ *
+ * tibiarc is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * tibiarc is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with tibiarc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "blitter.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#include "utils.hpp"
+
+#if !defined(DISABLE_SIMD)
+#    if defined(__x86_64__) || defined(_M_X64) ||                             \
+            (defined(__i386__) && defined(__SSE2__))
+/* SSE2 is part of the x86-64 baseline so we can use it unconditionally,
+ * whereas AVX2 is only used when the processor claims to support it. MSVC
+ * lacks the means to target individual functions, so we'll settle for SSE2
+ * there. */
+#        define BLITTER_SSE2
+#        include <emmintrin.h>
+#        if defined(__GNUC__) || defined(__clang__)
+#            define BLITTER_AVX2
+#            include <immintrin.h>
+#        endif
+#    elif defined(__wasm_simd128__)
+/* WebAssembly has no runtime feature detection, SIMD128 is enabled (or not)
+ * when building. */
+#        define BLITTER_SIMD128
+#        include <wasm_simd128.h>
+#    endif
+#endif
+
+namespace trc {
+namespace Blitter {
+
+static void FillScalar(const Pixel &color, Pixel *target, int count) {
+    for (int idx = 0; idx < count; idx++) {
+        target[idx] = color;
+    }
+}
+
+static void CopyMaskedScalar(const Pixel *source, Pixel *target, int count) {
+    for (int idx = 0; idx < count; idx++) {
+        if (!source[idx].IsTransparent()) {
+            target[idx] = source[idx];
+        }
+    }
+}
+
+static void ColorizeMaskedScalar(const Pixel *source,
+                                 const Pixel &color,
+                                 Pixel *target,
+                                 int count) {
+    for (int idx = 0; idx < count; idx++) {
+        const Pixel &tintKey = source[idx];
+
+        if (!tintKey.IsTransparent()) {
+            Pixel &targetPixel = target[idx];
+
+            targetPixel.Red = (tintKey.Red * color.Red) >> 8;
+            targetPixel.Green = (tintKey.Green * color.Green) >> 8;
+            targetPixel.Blue = (tintKey.Blue * color.Blue) >> 8;
+            targetPixel.Alpha = color.Alpha;
+        }
+    }
+}
+
+/* Tint keys as little-endian 32-bit words, see Pixel. */
+static constexpr uint32_t HeadKey = 0xFF00FFFF;
+static constexpr uint32_t PrimaryKey = 0xFF0000FF;
+static constexpr uint32_t SecondaryKey = 0xFF00FF00;
+static constexpr uint32_t DetailKey = 0xFFFF0000;
+
+/* Tint factor without alpha, as a little-endian 32-bit word. */
+[[maybe_unused]] static uint32_t TintFactor(const Pixel &color) {
+    return ((uint32_t)color.Red << 0) | ((uint32_t)color.Green << 8) |
+           ((uint32_t)color.Blue << 16);
+}
+
+static void TintMaskedScalar(const Pixel *source,
+                             const Pixel &head,
+                             const Pixel &primary,
+                             const Pixel &secondary,
+                             const Pixel &detail,
+                             Pixel *target,
+                             int count) {
+    for (int idx = 0; idx < count; idx++) {
+        const Pixel &tintKey = source[idx];
+        Pixel &targetPixel = target[idx];
+        const Pixel *color;
+
+        if (tintKey.IsTransparent()) {
+            continue;
+        } else if (tintKey.Red == 0 && tintKey.Green == 0 &&
+                   tintKey.Blue == 0xFF) {
+            color = &detail;
+        } else if (tintKey.Red == 0xFF && tintKey.Green == 0xFF &&
+                   tintKey.Blue == 0) {
+            color = &head;
+        } else if (tintKey.Red == 0 && tintKey.Green == 0xFF &&
+                   tintKey.Blue == 0) {
+            color = &secondary;
+        } else if (tintKey.Red == 0xFF && tintKey.Green == 0 &&
+                   tintKey.Blue == 0) {
+            color = &primary;
+        } else {
+            continue;
+        }
+
+        targetPixel.Red = targetPixel.Red * color->Red >> 8;
+        targetPixel.Green = targetPixel.Green * color->Green >> 8;
+        targetPixel.Blue = targetPixel.Blue * color->Blue >> 8;
+    }
+}
+
+static void ReplicateScalar(const Pixel *source,
+                            int factor,
+                            Pixel *target,
+                            int count) {
+    for (int idx = 0; idx < count; idx++) {
+        for (int copy = 0; copy < factor; copy++) {
+            *target++ = source[idx];
+        }
+    }
+}
+
+static void BlendScalar(const Pixel *first,
+                        const Pixel *second,
+                        int weight,
+                        Pixel *target,
+                        int count) {
+    const int inverse = 256 - weight;
+
+    for (int idx = 0; idx < count; idx++) {
+        target[idx].Red =
+                (first[idx].Red * inverse + second[idx].Red * weight + 128) >>
+                8;
+        target[idx].Green = (first[idx].Green * inverse +
+                             second[idx].Green * weight + 128) >>
+                            8;
+        target[idx].Blue = (first[idx].Blue * inverse +
+                            second[idx].Blue * weight + 128) >>
+                           8;
+        target[idx].Alpha = (first[idx].Alpha * inverse +
+                             second[idx].Alpha * weight + 128) >>
+                            8;
+    }
+}
+
+#ifdef BLITTER_SSE2
+static void FillSSE2(const Pixel &color, Pixel *target, int count) {
+    uint32_t word;
+    std::memcpy(&word, &color, sizeof(word));
+
+    const __m128i splat = _mm_set1_epi32((int)word);
+    int idx = 0;
+
+    for (; idx + 4 <= count; idx += 4) {
+        _mm_storeu_si128((__m128i *)&target[idx], splat);
+    }
+
+    FillScalar(color, &target[idx], count - idx);
+}
+
+static void CopyMaskedSSE2(const Pixel *source, Pixel *target, int count) {
+    const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+    int idx = 0;
+
+    for (; idx + 4 <= count; idx += 4) {
+        __m128i from = _mm_loadu_si128((const __m128i *)&source[idx]);
+        __m128i to = _mm_loadu_si128((const __m128i *)&target[idx]);
+        __m128i opaque =
+                _mm_cmpeq_epi32(_mm_and_si128(from, alphaMask), alphaMask);
+
+        to = _mm_or_si128(_mm_and_si128(opaque, from),
+                          _mm_andnot_si128(opaque, to));
+        _mm_storeu_si128((__m128i *)&target[idx], to);
+    }
+
+    CopyMaskedScalar(&source[idx], &target[idx], count - idx);
+}
+
+static void ColorizeMaskedSSE2(const Pixel *source,
+                               const Pixel &color,
+                               Pixel *target,
+                               int count) {
+    const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+    const __m128i zero = _mm_setzero_si128();
+    /* The alpha lane is multiplied by zero and then replaced by that of the
+     * color. */
+    const __m128i factor = _mm_set_epi16(0,
+                                         color.Blue,
+                                         color.Green,
+                                         color.Red,
+                                         0,
+                                         color.Blue,
+                                         color.Green,
+                                         color.Red);
+    const __m128i alpha = _mm_set1_epi32((int)((uint32_t)color.Alpha << 24));
+    int idx = 0;
+
+    for (; idx + 4 <= count; idx += 4) {
+        __m128i from = _mm_loadu_si128((const __m128i *)&source[idx]);
+        __m128i to = _mm_loadu_si128((const __m128i *)&target[idx]);
+        __m128i opaque =
+                _mm_cmpeq_epi32(_mm_and_si128(from, alphaMask), alphaMask);
+
+        __m128i low = _mm_mullo_epi16(_mm_unpacklo_epi8(from, zero), factor);
+        __m128i high = _mm_mullo_epi16(_mm_unpackhi_epi8(from, zero), factor);
+        __m128i colorized =
+                _mm_or_si128(_mm_packus_epi16(_mm_srli_epi16(low, 8),
+                                              _mm_srli_epi16(high, 8)),
+                             alpha);
+
+        to = _mm_or_si128(_mm_and_si128(opaque, colorized),
+                          _mm_andnot_si128(opaque, to));
+        _mm_storeu_si128((__m128i *)&target[idx], to);
+    }
+
+    ColorizeMaskedScalar(&source[idx], color, &target[idx], count - idx);
+}
+
+static void TintMaskedSSE2(const Pixel *source,
+                           const Pixel &head,
+                           const Pixel &primary,
+                           const Pixel &secondary,
+                           const Pixel &detail,
+                           Pixel *target,
+                           int count) {
+    const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i headKey = _mm_set1_epi32((int)HeadKey);
+    const __m128i primaryKey = _mm_set1_epi32((int)PrimaryKey);
+    const __m128i secondaryKey = _mm_set1_epi32((int)SecondaryKey);
+    const __m128i detailKey = _mm_set1_epi32((int)DetailKey);
+    const __m128i headFactor = _mm_set1_epi32((int)TintFactor(head));
+    const __m128i primaryFactor = _mm_set1_epi32((int)TintFactor(primary));
+    const __m128i secondaryFactor =
+            _mm_set1_epi32((int)TintFactor(secondary));
+    const __m128i detailFactor = _mm_set1_epi32((int)TintFactor(detail));
+    int idx = 0;
+
+    for (; idx + 4 <= count; idx += 4) {
+        __m128i from = _mm_loadu_si128((const __m128i *)&source[idx]);
+        __m128i to = _mm_loadu_si128((const __m128i *)&target[idx]);
+
+        /* The keys are mutually exclusive, so we can build the per-pixel
+         * factor by OR:ing the masked factors together. The alpha lane of
+         * each factor is zero, and is restored from the target below. */
+        __m128i isHead = _mm_cmpeq_epi32(from, headKey);
+        __m128i isPrimary = _mm_cmpeq_epi32(from, primaryKey);
+        __m128i isSecondary = _mm_cmpeq_epi32(from, secondaryKey);
+        __m128i isDetail = _mm_cmpeq_epi32(from, detailKey);
+        __m128i tinted = _mm_or_si128(_mm_or_si128(isHead, isPrimary),
+                                      _mm_or_si128(isSecondary, isDetail));
+        __m128i factor = _mm_or_si128(
+                _mm_or_si128(_mm_and_si128(isHead, headFactor),
+                             _mm_and_si128(isPrimary, primaryFactor)),
+                _mm_or_si128(_mm_and_si128(isSecondary, secondaryFactor),
+                             _mm_and_si128(isDetail, detailFactor)));
+
+        __m128i low = _mm_mullo_epi16(_mm_unpacklo_epi8(to, zero),
+                                      _mm_unpacklo_epi8(factor, zero));
+        __m128i high = _mm_mullo_epi16(_mm_unpackhi_epi8(to, zero),
+                                       _mm_unpackhi_epi8(factor, zero));
+        __m128i product = _mm_or_si128(
+                _mm_packus_epi16(_mm_srli_epi16(low, 8),
+                                 _mm_srli_epi16(high, 8)),
+                _mm_and_si128(to, alphaMask));
+
+        to = _mm_or_si128(_mm_and_si128(tinted, product),
+                          _mm_andnot_si128(tinted, to));
+        _mm_storeu_si128((__m128i *)&target[idx], to);
+    }
+
+    TintMaskedScalar(&source[idx],
+                     head,
+                     primary,
+                     secondary,
+                     detail,
+                     &target[idx],
+                     count - idx);
+}
+
+/* Handles the common integer scales with shuffles, leaving the others to the
+ * scalar version. */
+static void ReplicateSSE2(const Pixel *source,
+                          int factor,
+                          Pixel *target,
+                          int count) {
+    int idx = 0;
+
+    switch (factor) {
+    case 1:
+        std::memcpy((void *)target, source, count * sizeof(Pixel));
+        return;
+    case 2:
+        for (; idx + 4 <= count; idx += 4) {
+            __m128i from = _mm_loadu_si128((const __m128i *)&source[idx]);
+            __m128i *to = (__m128i *)&target[idx * 2];
+
+            _mm_storeu_si128(&to[0], _mm_unpacklo_epi32(from, from));
+            _mm_storeu_si128(&to[1], _mm_unpackhi_epi32(from, from));
+        }
+        break;
+    case 3:
+        for (; idx + 4 <= count; idx += 4) {
+            __m128i from = _mm_loadu_si128((const __m128i *)&source[idx]);
+            __m128i *to = (__m128i *)&target[idx * 3];
+
+            _mm_storeu_si128(&to[0],
+                             _mm_shuffle_epi32(from, _MM_SHUFFLE(1, 0, 0, 0)));
+            _mm_storeu_si128(&to[1],
+                             _mm_shuffle_epi32(from, _MM_SHUFFLE(2, 2, 1, 1)));
+            _mm_storeu_si128(&to[2],
+                             _mm_shuffle_epi32(from, _MM_SHUFFLE(3, 3, 3, 2)));
+        }
+        break;
+    case 4:
+        for (; idx + 4 <= count; idx += 4) {
+            __m128i from = _mm_loadu_si128((const __m128i *)&source[idx]);
+            __m128i *to = (__m128i *)&target[idx * 4];
+
+            _mm_storeu_si128(&to[0],
+                             _mm_shuffle_epi32(from, _MM_SHUFFLE(0, 0, 0, 0)));
+            _mm_storeu_si128(&to[1],
+                             _mm_shuffle_epi32(from, _MM_SHUFFLE(1, 1, 1, 1)));
+            _mm_storeu_si128(&to[2],
+                             _mm_shuffle_epi32(from, _MM_SHUFFLE(2, 2, 2, 2)));
+            _mm_storeu_si128(&to[3],
+                             _mm_shuffle_epi32(from, _MM_SHUFFLE(3, 3, 3, 3)));
+        }
+        break;
+    }
+
+    ReplicateScalar(&source[idx],
+                    factor,
+                    &target[idx * factor],
+                    count - idx);
+}
+
+static void BlendSSE2(const Pixel *first,
+                      const Pixel *second,
+                      int weight,
+                      Pixel *target,
+                      int count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i firstWeight = _mm_set1_epi16((short)(256 - weight));
+    const __m128i secondWeight = _mm_set1_epi16((short)weight);
+    const __m128i round = _mm_set1_epi16(128);
+    int idx = 0;
+
+    /* 255 * 256 fits in 16 bits, so the sums can't overflow. */
+    for (; idx + 4 <= count; idx += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i *)&first[idx]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&second[idx]);
+
+        __m128i low = _mm_add_epi16(
+                _mm_add_epi16(
+                        _mm_mullo_epi16(_mm_unpacklo_epi8(a, zero),
+                                        firstWeight),
+                        _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero),
+                                        secondWeight)),
+                round);
+        __m128i high = _mm_add_epi16(
+                _mm_add_epi16(
+                        _mm_mullo_epi16(_mm_unpackhi_epi8(a, zero),
+                                        firstWeight),
+                        _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero),
+                                        secondWeight)),
+                round);
+
+        _mm_storeu_si128((__m128i *)&target[idx],
+                         _mm_packus_epi16(_mm_srli_epi16(low, 8),
+                                          _mm_srli_epi16(high, 8)));
+    }
+
+    BlendScalar(&first[idx], &second[idx], weight, &target[idx], count - idx);
+}
+#endif
+
+#ifdef BLITTER_AVX2
+__attribute__((target("avx2"))) static void FillAVX2(
+        const Pixel &color,
+        Pixel *target,
+        int count) {
+    uint32_t word;
+    std::memcpy(&word, &color, sizeof(word));
+
+    const __m256i splat = _mm256_set1_epi32((int)word);
+    int idx = 0;
+
+    for (; idx + 8 <= count; idx += 8) {
+        _mm256_storeu_si256((__m256i *)&target[idx], splat);
+    }
+
+    FillSSE2(color, &target[idx], count - idx);
+}
+
+__attribute__((target("avx2"))) static void CopyMaskedAVX2(
+        const Pixel *source,
+        Pixel *target,
+        int count) {
+    const __m256i alphaMask = _mm256_set1_epi32((int)0xFF000000);
+    int idx = 0;
+
+    for (; idx + 8 <= count; idx += 8) {
+        __m256i from = _mm256_loadu_si256((const __m256i *)&source[idx]);
+        __m256i to = _mm256_loadu_si256((const __m256i *)&target[idx]);
+        __m256i opaque = _mm256_cmpeq_epi32(_mm256_and_si256(from, alphaMask),
+                                            alphaMask);
+
+        _mm256_storeu_si256((__m256i *)&target[idx],
+                            _mm256_blendv_epi8(to, from, opaque));
+    }
+
+    CopyMaskedSSE2(&source[idx], &target[idx], count - idx);
+}
+
+__attribute__((target("avx2"))) static void ColorizeMaskedAVX2(
+        const Pixel *source,
+        const Pixel &color,
+        Pixel *target,
+        int count) {
+    const __m256i alphaMask = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i factor =
+            _mm256_broadcastsi128_si256(_mm_set_epi16(0,
+                                                      color.Blue,
+                                                      color.Green,
+                                                      color.Red,
+                                                      0,
+                                                      color.Blue,
+                                                      color.Green,
+                                                      color.Red));
+    const __m256i alpha =
+            _mm256_set1_epi32((int)((uint32_t)color.Alpha << 24));
+    int idx = 0;
+
+    for (; idx + 8 <= count; idx += 8) {
+        __m256i from = _mm256_loadu_si256((const __m256i *)&source[idx]);
+        __m256i to = _mm256_loadu_si256((const __m256i *)&target[idx]);
+        __m256i opaque = _mm256_cmpeq_epi32(_mm256_and_si256(from, alphaMask),
+                                            alphaMask);
+
+        /* Unpacking and packing both operate within 128-bit lanes, so the
+         * pixel order is preserved. */
+        __m256i low = _mm256_mullo_epi16(_mm256_unpacklo_epi8(from, zero),
+                                         factor);
+        __m256i high = _mm256_mullo_epi16(_mm256_unpackhi_epi8(from, zero),
+                                          factor);
+        __m256i colorized = _mm256_or_si256(
+                _mm256_packus_epi16(_mm256_srli_epi16(low, 8),
+                                    _mm256_srli_epi16(high, 8)),
+                alpha);
+
+        _mm256_storeu_si256((__m256i *)&target[idx],
+                            _mm256_blendv_epi8(to, colorized, opaque));
+    }
+
+    ColorizeMaskedSSE2(&source[idx], color, &target[idx], count - idx);
+}
+
+__attribute__((target("avx2"))) static void TintMaskedAVX2(
+        const Pixel *source,
+        const Pixel &head,
+        const Pixel &primary,
+        const Pixel &secondary,
+        const Pixel &detail,
+        Pixel *target,
+        int count) {
+    const __m256i alphaMask = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i headKey = _mm256_set1_epi32((int)HeadKey);
+    const __m256i primaryKey = _mm256_set1_epi32((int)PrimaryKey);
+    const __m256i secondaryKey = _mm256_set1_epi32((int)SecondaryKey);
+    const __m256i detailKey = _mm256_set1_epi32((int)DetailKey);
+    const __m256i headFactor = _mm256_set1_epi32((int)TintFactor(head));
+    const __m256i primaryFactor =
+            _mm256_set1_epi32((int)TintFactor(primary));
+    const __m256i secondaryFactor =
+            _mm256_set1_epi32((int)TintFactor(secondary));
+    const __m256i detailFactor = _mm256_set1_epi32((int)TintFactor(detail));
+    int idx = 0;
+
+    for (; idx + 8 <= count; idx += 8) {
+        __m256i from = _mm256_loadu_si256((const __m256i *)&source[idx]);
+        __m256i to = _mm256_loadu_si256((const __m256i *)&target[idx]);
+
+        __m256i isHead = _mm256_cmpeq_epi32(from, headKey);
+        __m256i isPrimary = _mm256_cmpeq_epi32(from, primaryKey);
+        __m256i isSecondary = _mm256_cmpeq_epi32(from, secondaryKey);
+        __m256i isDetail = _mm256_cmpeq_epi32(from, detailKey);
+        __m256i tinted =
+                _mm256_or_si256(_mm256_or_si256(isHead, isPrimary),
+                                _mm256_or_si256(isSecondary, isDetail));
+        __m256i factor = _mm256_or_si256(
+                _mm256_or_si256(_mm256_and_si256(isHead, headFactor),
+                                _mm256_and_si256(isPrimary, primaryFactor)),
+                _mm256_or_si256(
+                        _mm256_and_si256(isSecondary, secondaryFactor),
+                        _mm256_and_si256(isDetail, detailFactor)));
+
+        __m256i low = _mm256_mullo_epi16(_mm256_unpacklo_epi8(to, zero),
+                                         _mm256_unpacklo_epi8(factor, zero));
+        __m256i high = _mm256_mullo_epi16(_mm256_unpackhi_epi8(to, zero),
+                                          _mm256_unpackhi_epi8(factor, zero));
+        __m256i product = _mm256_or_si256(
+                _mm256_packus_epi16(_mm256_srli_epi16(low, 8),
+                                    _mm256_srli_epi16(high, 8)),
+                _mm256_and_si256(to, alphaMask));
+
+        _mm256_storeu_si256((__m256i *)&target[idx],
+                            _mm256_blendv_epi8(to, product, tinted));
+    }
+
+    TintMaskedSSE2(&source[idx],
+                   head,
+                   primary,
+                   secondary,
+                   detail,
+                   &target[idx],
+                   count - idx);
+}
+#endif
+
+#ifdef BLITTER_SIMD128
+static void FillSIMD128(const Pixel &color, Pixel *target, int count) {
+    uint32_t word;
+    std::memcpy(&word, &color, sizeof(word));
+
+    const v128_t splat = wasm_i32x4_splat((int32_t)word);
+    int idx = 0;
+
+    for (; idx + 4 <= count; idx += 4) {
+        wasm_v128_store(&target[idx], splat);
+    }
+
+    FillScalar(color, &target[idx], count - idx);
+}
+
+static void TintMaskedSIMD128(const Pixel *source,
+                              const Pixel &head,
+                              const Pixel &primary,
+                              const Pixel &secondary,
+                              const Pixel &detail,
+                              Pixel *target,
+                              int count) {
+    const v128_t alphaMask = wasm_i32x4_splat((int32_t)0xFF000000);
+    const v128_t headKey = wasm_i32x4_splat((int32_t)HeadKey);
+    const v128_t primaryKey = wasm_i32x4_splat((int32_t)PrimaryKey);
+    const v128_t secondaryKey = wasm_i32x4_splat((int32_t)SecondaryKey);
+    const v128_t detailKey = wasm_i32x4_splat((int32_t)DetailKey);
+    const v128_t headFactor = wasm_i32x4_splat((int32_t)TintFactor(head));
+    const v128_t primaryFactor =
+            wasm_i32x4_splat((int32_t)TintFactor(primary));
+    const v128_t secondaryFactor =
+            wasm_i32x4_splat((int32_t)TintFactor(secondary));
+    const v128_t detailFactor = wasm_i32x4_splat((int32_t)TintFactor(detail));
+    int idx = 0;
+
+    for (; idx + 4 <= count; idx += 4) {
+        v128_t from = wasm_v128_load(&source[idx]);
+        v128_t to = wasm_v128_load(&target[idx]);
+
+        v128_t isHead = wasm_i32x4_eq(from, headKey);
+        v128_t isPrimary = wasm_i32x4_eq(from, primaryKey);
+        v128_t isSecondary = wasm_i32x4_eq(from, secondaryKey);
+        v128_t isDetail = wasm_i32x4_eq(from, detailKey);
+        v128_t tinted = wasm_v128_or(wasm_v128_or(isHead, isPrimary),
+                                     wasm_v128_or(isSecondary, isDetail));
+        v128_t factor = wasm_v128_or(
+                wasm_v128_or(wasm_v128_and(isHead, headFactor),
+                             wasm_v128_and(isPrimary, primaryFactor)),
+                wasm_v128_or(wasm_v128_and(isSecondary, secondaryFactor),
+                             wasm_v128_and(isDetail, detailFactor)));
+
+        v128_t low = wasm_i16x8_mul(wasm_u16x8_extend_low_u8x16(to),
+                                    wasm_u16x8_extend_low_u8x16(factor));
+        v128_t high = wasm_i16x8_mul(wasm_u16x8_extend_high_u8x16(to),
+                                     wasm_u16x8_extend_high_u8x16(factor));
+        v128_t product = wasm_v128_or(
+                wasm_u8x16_narrow_i16x8(wasm_u16x8_shr(low, 8),
+                                        wasm_u16x8_shr(high, 8)),
+                wasm_v128_and(to, alphaMask));
+
+        wasm_v128_store(&target[idx],
+                        wasm_v128_bitselect(product, to, tinted));
+    }
+
+    TintMaskedScalar(&source[idx],
+                     head,
+                     primary,
+                     secondary,
+                     detail,
+                     &target[idx],
+                     count - idx);
+}
+#endif
+
+struct Kernels {
+    void (*Fill)(const Pixel &, Pixel *, int);
+    void (*CopyMasked)(const Pixel *, Pixel *, int);
+    void (*ColorizeMasked)(const Pixel *, const Pixel &, Pixel *, int);
+    void (*TintMasked)(const Pixel *,
+                       const Pixel &,
+                       const Pixel &,
+                       const Pixel &,
+                       const Pixel &,
+                       Pixel *,
+                       int);
+    void (*Replicate)(const Pixel *, int, Pixel *, int);
+    void (*Blend)(const Pixel *, const Pixel *, int, Pixel *, int);
+
+    Kernels() {
+        /* These are bound by memory bandwidth, so SSE2 will do. */
+#if defined(BLITTER_SSE2)
+        Replicate = ReplicateSSE2;
+        Blend = BlendSSE2;
+#else
+        Replicate = ReplicateScalar;
+        Blend = BlendScalar;
+#endif
+
+#if defined(BLITTER_AVX2)
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2")) {
+            Fill = FillAVX2;
+            CopyMasked = CopyMaskedAVX2;
+            ColorizeMasked = ColorizeMaskedAVX2;
+            TintMasked = TintMaskedAVX2;
+            return;
+        }
+#endif
+
+#if defined(BLITTER_SSE2)
+        Fill = FillSSE2;
+        CopyMasked = CopyMaskedSSE2;
+        ColorizeMasked = ColorizeMaskedSSE2;
+        TintMasked = TintMaskedSSE2;
+#else
+        CopyMasked = CopyMaskedScalar;
+        ColorizeMasked = ColorizeMaskedScalar;
+#    if defined(BLITTER_SIMD128)
+        Fill = FillSIMD128;
+        TintMasked = TintMaskedSIMD128;
+#    else
+        Fill = FillScalar;
+        TintMasked = TintMaskedScalar;
+#    endif
+#endif
+    }
+};
+
+static const Kernels &GetKernels() {
+    static const Kernels kernels;
+    return kernels;
+}
+
+void Fill(const Pixel &color, Pixel *target, int count) {
+    Assert(count >= 0);
+    GetKernels().Fill(color, target, count);
+}
+
+void CopyMasked(const Pixel *source, Pixel *target, int count) {
+    Assert(count >= 0);
+    GetKernels().CopyMasked(source, target, count);
+}
+
+void ColorizeMasked(const Pixel *source,
+                    const Pixel &color,
+                    Pixel *target,
+                    int count) {
+    Assert(count >= 0);
+    GetKernels().ColorizeMasked(source, color, target, count);
+}
+
+void TintMasked(const Pixel *source,
+                const Pixel &head,
+                const Pixel &primary,
+                const Pixel &secondary,
+                const Pixel &detail,
+                Pixel *target,
+                int count) {
+    Assert(count >= 0);
+    GetKernels().TintMasked(source,
+                            head,
+                            primary,
+                            secondary,
+                            detail,
+                            target,
+                            count);
+}
+
+void Replicate(const Pixel *source, int factor, Pixel *target, int count) {
+    Assert(count >= 0 && factor > 0);
+    GetKernels().Replicate(source, factor, target, count);
+}
+
+void Blend(const Pixel *first,
+           const Pixel *second,
+           int weight,
+           Pixel *target,
+           int count) {
+    Assert(count >= 0 && weight >= 0 && weight <= 256);
+    GetKernels().Blend(first, second, weight, target, count);
+}
+
+} // namespace Blitter
+} // namespace trc
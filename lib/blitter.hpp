@@ -0,0 +1,75 @@
+/*
+ * Copyright 2025 "John Högberg"
+ *
+ * This file is part of tibiarc.
+ *
+ * tibiarc is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * tibiarc is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with tibiarc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TRC_BLITTER_HPP__
+#define __TRC_BLITTER_HPP__
+
+#include "pixel.hpp"
+
+namespace trc {
+namespace Blitter {
+
+/* Row kernels operating on decoded sprites (see Sprite::Pixels), where
+ * transparent pixels have been zeroed out and opaque pixels have an alpha of
+ * 0xFF. The alpha channel doubles as the coverage mask.
+ *
+ * The fastest implementation supported by the running processor is picked on
+ * first use. */
+
+/* Sets `count` pixels in `target` to `color`. */
+void Fill(const Pixel &color, Pixel *target, int count);
+
+/* Copies all opaque pixels in `source` to `target`. */
+void CopyMasked(const Pixel *source, Pixel *target, int count);
+
+/* Copies all opaque pixels in `source` to `target`, multiplying them by
+ * `color` and replacing their alpha with that of `color`. */
+void ColorizeMasked(const Pixel *source,
+                    const Pixel &color,
+                    Pixel *target,
+                    int count);
+
+/* Multiplies the pixels in `target` by `head`, `primary`, `secondary`, or
+ * `detail` wherever `source` holds the respective tint key (yellow, red,
+ * green, or blue), leaving their alpha as-is. */
+void TintMasked(const Pixel *source,
+                const Pixel &head,
+                const Pixel &primary,
+                const Pixel &secondary,
+                const Pixel &detail,
+                Pixel *target,
+                int count);
+
+/* Writes each of the `count` pixels in `source` `factor` times in a row to
+ * `target`, which must have room for `count * factor` pixels. */
+void Replicate(const Pixel *source, int factor, Pixel *target, int count);
+
+/* Blends `first` and `second` into `target`, weighing `second` by
+ * `weight / 256` and `first` by the remainder. Unlike the kernels above, this
+ * applies to all channels alike, alpha included. */
+void Blend(const Pixel *first,
+           const Pixel *second,
+           int weight,
+           Pixel *target,
+           int count);
+
+} // namespace Blitter
+} // namespace trc
+
+#endif /* __TRC_BLITTER_HPP__ */
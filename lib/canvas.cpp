@@ -19,10 +19,13 @@
  */
 
 #include "canvas.hpp"
+#include "blitter.hpp"
 
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <utility>
+#include <vector>
 
 #include "utils.hpp"
 
@@ -87,7 +90,7 @@ static void AlignedDeallocate(void *ptr) {
 }
 
 Canvas::Canvas(int width, int height, Canvas::Type kind)
-    : Kind(kind), Width(width), Height(height) {
+    : Kind(kind), Width(width), Height(height), Blits{} {
     static_assert((LEVEL1_DCACHE_LINESIZE & -LEVEL1_DCACHE_LINESIZE) ==
                           LEVEL1_DCACHE_LINESIZE,
                   "Assumed cache line size must be a power of 2");
@@ -99,54 +102,357 @@ Canvas::Canvas(int width, int height, Canvas::Type kind)
                  ~LEVEL1_DCACHE_LINEMASK;
         Buffer = (uint8_t *)AlignedAllocate(LEVEL1_DCACHE_LINESIZE,
                                             (Height + 1) * Stride);
+        Owner = std::shared_ptr<const void>(Buffer, AlignedDeallocate);
+    } else {
+        Stride = 0;
+        Buffer = nullptr;
     }
 }
 
-Canvas::Canvas(int width, int height, int stride, uint8_t *buffer)
-    : Kind(Canvas::Type::Slice),
+Canvas::Canvas(int width,
+               int height,
+               int stride,
+               uint8_t *buffer,
+               std::shared_ptr<const void> owner)
+    : Canvas(width, height, stride, buffer, std::move(owner), Type::External) {
+    AbortUnless(buffer == nullptr || stride >= width * (int)sizeof(Pixel));
+}
+
+Canvas::Canvas(int width,
+               int height,
+               int stride,
+               uint8_t *buffer,
+               std::shared_ptr<const void> owner,
+               Canvas::Type kind)
+    : Owner(std::move(owner)),
+      Kind(kind),
       Width(width),
       Height(height),
       Stride(stride),
-      Buffer(buffer) {
+      Buffer(buffer),
+      Blits{} {
 }
 
 const Canvas Canvas::Slice(int leftX, int topY, int rightX, int bottomY) {
     return Canvas(rightX - leftX,
                   bottomY - topY,
                   Stride,
-                  (uint8_t *)&GetPixel(leftX, topY));
+                  (uint8_t *)&GetPixel(leftX, topY),
+                  Owner,
+                  Type::Slice);
 }
 
-Canvas::~Canvas() {
-    if (Kind == Type::Internal) {
-        AlignedDeallocate(Buffer);
+void Canvas::Fill(const Pixel &color,
+                  const int x,
+                  const int y,
+                  const int width,
+                  const int height) {
+    const int leftX = std::max(x, 0);
+    const int topY = std::max(y, 0);
+    const int rightX = std::min(x + width, Width);
+    const int bottomY = std::min(y + height, Height);
+
+    if (leftX >= rightX) {
+        return;
     }
 
-    /* FIXME: C++ migration, keep parent alive somehow. */
+    for (int yIdx = topY; yIdx < bottomY; yIdx++) {
+        Blitter::Fill(color, &GetPixel(leftX, yIdx), rightX - leftX);
+    }
 }
 
-void Canvas::DrawRectangle(const Pixel &color,
-                           const int x,
-                           const int y,
-                           const int width,
-                           const int height) {
-    if (!((x < Width) && (y < Height) && (x + width >= 0) &&
-          (y + height >= 0))) {
+/* Clips a copy of the given rectangle of `source` to (x, y) against both
+ * canvases, calling `function(from, to, count)` for each row that remains. */
+template <typename Function>
+static void ForEachCopiedRow(const Canvas &source,
+                             int sourceX,
+                             int sourceY,
+                             Canvas &target,
+                             int x,
+                             int y,
+                             int width,
+                             int height,
+                             Function function) {
+    /* Clip the top-left corner against both canvases, then the size. */
+    const int skipX = std::max({0, -sourceX, -x});
+    const int skipY = std::max({0, -sourceY, -y});
+
+    sourceX += skipX;
+    sourceY += skipY;
+    x += skipX;
+    y += skipY;
+
+    width = std::min({width - skipX, source.Width - sourceX, target.Width - x});
+    height = std::min(
+            {height - skipY, source.Height - sourceY, target.Height - y});
+
+    if (width <= 0) {
+        return;
+    }
+
+    for (int yIdx = 0; yIdx < height; yIdx++) {
+        function(&source.GetPixel(sourceX, sourceY + yIdx),
+                 &target.GetPixel(x, y + yIdx),
+                 width);
+    }
+}
+
+void Canvas::Blit(const Canvas &source,
+                  int sourceX,
+                  int sourceY,
+                  int x,
+                  int y,
+                  int width,
+                  int height) {
+    ForEachCopiedRow(source,
+                     sourceX,
+                     sourceY,
+                     *this,
+                     x,
+                     y,
+                     width,
+                     height,
+                     [](const Pixel *from, Pixel *to, int count) {
+                         std::memcpy((void *)to, from, count * sizeof(Pixel));
+                     });
+}
+
+void Canvas::Composite(const Canvas &source,
+                       int sourceX,
+                       int sourceY,
+                       int x,
+                       int y,
+                       int width,
+                       int height) {
+    ForEachCopiedRow(source,
+                     sourceX,
+                     sourceY,
+                     *this,
+                     x,
+                     y,
+                     width,
+                     height,
+                     [](const Pixel *from, Pixel *to, int count) {
+                         Blitter::CopyMasked(from, to, count);
+                     });
+}
+
+/* Scales `source` to `count` pixels horizontally, where `columns` holds the
+ * index of the left source pixel of each target pixel shifted up by 8 bits,
+ * and the weight of the right one in the lower 8 bits. */
+static void ScaleRow(const Pixel *source,
+                     int lastX,
+                     const uint32_t *columns,
+                     Pixel *target,
+                     int count) {
+    for (int idx = 0; idx < count; idx++) {
+        const int fromX = columns[idx] >> 8;
+        const uint32_t weight = columns[idx] & 0xFF;
+        const uint32_t inverse = 256 - weight;
+        uint32_t left, right;
+
+        std::memcpy(&left, &source[fromX], sizeof(left));
+        std::memcpy(&right,
+                    &source[std::min(fromX + 1, lastX)],
+                    sizeof(right));
+
+        /* Blend two channels at a time, 255 * 256 fits in the 16 bits that
+         * each channel has to itself. */
+        const uint32_t redBlue = ((left & 0x00FF00FF) * inverse +
+                                  (right & 0x00FF00FF) * weight + 0x00800080) >>
+                                 8;
+        const uint32_t greenAlpha = ((left >> 8) & 0x00FF00FF) * inverse +
+                                    ((right >> 8) & 0x00FF00FF) * weight +
+                                    0x00800080;
+        const uint32_t blended =
+                (redBlue & 0x00FF00FF) | (greenAlpha & 0xFF00FF00);
+
+        std::memcpy((void *)&target[idx], &blended, sizeof(blended));
+    }
+}
+
+void Canvas::Scale(const Canvas &source,
+                   const int x,
+                   const int y,
+                   const int width,
+                   const int height) {
+    AbortUnless(x >= 0 && y >= 0 && width >= 0 && height >= 0 &&
+                x + width <= Width && y + height <= Height);
+
+    if (width == 0 || height == 0 || source.Width == 0 || source.Height == 0) {
         return;
     }
 
-    for (int xIdx = std::max(x, 0); xIdx < std::min(x + width, Width); xIdx++) {
-        memcpy(&GetPixel(xIdx, y), &color, sizeof(Pixel));
+    if (width % source.Width == 0 && height % source.Height == 0) {
+        const int factorX = width / source.Width;
+        const int factorY = height / source.Height;
+
+        for (int fromY = 0; fromY < source.Height; fromY++) {
+            Pixel *first = &GetPixel(x, y + fromY * factorY);
+
+            Blitter::Replicate(&source.GetPixel(0, fromY),
+                               factorX,
+                               first,
+                               source.Width);
+
+            for (int copy = 1; copy < factorY; copy++) {
+                std::memcpy((void *)&GetPixel(x, y + fromY * factorY + copy),
+                            first,
+                            width * sizeof(Pixel));
+            }
+        }
+
+        return;
     }
 
-    for (int yIdx = std::max(y + 1, 0); yIdx < std::min(y + height, Height);
-         yIdx++) {
-        int pixelsToCopy = std::min(x + width, Width) - std::max(x, 0);
+    /* Map the top-left corners of the pixels onto each other in 16.16 fixed
+     * point, blending each column and then each row. Positions are computed
+     * directly rather than stepped to keep rounding errors from piling up
+     * towards the edges. As rows are filtered top to bottom, each source row
+     * only needs to be scaled once. */
+    std::vector<uint32_t> columns(width);
+
+    for (int toX = 0; toX < width; toX++) {
+        const uint64_t fromX = ((uint64_t)toX * source.Width << 16) / width;
+
+        columns[toX] = (std::min<uint32_t>(fromX >> 16, source.Width - 1)
+                        << 8) |
+                       ((fromX >> 8) & 0xFF);
+    }
 
-        if (pixelsToCopy > 0) {
-            memcpy(&GetPixel(std::max(x, 0), yIdx),
-                   &GetPixel(std::max(x, 0), y),
-                   sizeof(Pixel) * pixelsToCopy);
+    std::vector<Pixel> top(width, Pixel::Transparent());
+    std::vector<Pixel> bottom(width, Pixel::Transparent());
+    int topY = -1, bottomY = -1;
+
+    for (int toY = 0; toY < height; toY++) {
+        const uint64_t fromY = ((uint64_t)toY * source.Height << 16) / height;
+        const int firstY = std::min<int>(fromY >> 16, source.Height - 1);
+        const int secondY = std::min(firstY + 1, source.Height - 1);
+
+        if (firstY == bottomY) {
+            std::swap(top, bottom);
+            std::swap(topY, bottomY);
+        }
+
+        if (firstY != topY) {
+            ScaleRow(&source.GetPixel(0, firstY),
+                     source.Width - 1,
+                     columns.data(),
+                     top.data(),
+                     width);
+            topY = firstY;
+        }
+
+        if (secondY != bottomY) {
+            ScaleRow(&source.GetPixel(0, secondY),
+                     source.Width - 1,
+                     columns.data(),
+                     bottom.data(),
+                     width);
+            bottomY = secondY;
+        }
+
+        Blitter::Blend(top.data(),
+                       bottom.data(),
+                       (fromY >> 8) & 0xFF,
+                       &GetPixel(x, y + toY),
+                       width);
+    }
+}
+
+void Canvas::TileFill(const Sprite &sprite,
+                      const int x,
+                      const int y,
+                      const int width,
+                      const int height) {
+    const Sprite::Coverage coverage = sprite.GetCoverage();
+
+    if (coverage == Sprite::Coverage::Empty) {
+        return;
+    } else if (coverage != Sprite::Coverage::Opaque) {
+        /* Transparent parts must leave whatever is beneath alone, so we'll
+         * have to draw each tile on its own. */
+        for (int toY = y; toY < (y + height); toY += sprite.Height) {
+            for (int toX = x; toX < (x + width); toX += sprite.Width) {
+                Draw(sprite,
+                     toX,
+                     toY,
+                     std::min(sprite.Width, (x + width) - toX),
+                     std::min(sprite.Height, (y + height) - toY));
+            }
+        }
+
+        return;
+    }
+
+    const int leftX = std::max(x, 0);
+    const int topY = std::max(y, 0);
+    const int rightX = std::min(x + width, Width);
+    const int bottomY = std::min(y + height, Height);
+
+    if (leftX >= rightX) {
+        return;
+    }
+
+    const Pixel *pixels = sprite.Pixels();
+
+    for (int yIdx = topY; yIdx < bottomY; yIdx++) {
+        if ((yIdx - sprite.Height) >= topY) {
+            /* Every row past the first band of tiles repeats the one a tile
+             * above it, letting us copy whole canvas rows at a time. */
+            std::memcpy((void *)&GetPixel(leftX, yIdx),
+                        &GetPixel(leftX, yIdx - sprite.Height),
+                        (rightX - leftX) * sizeof(Pixel));
+            continue;
+        }
+
+        const Pixel *row = &pixels[((yIdx - y) % sprite.Height) * sprite.Width];
+
+        for (int xIdx = leftX; xIdx < rightX;) {
+            const int column = (xIdx - x) % sprite.Width;
+            const int count = std::min(sprite.Width - column, rightX - xIdx);
+
+            std::memcpy((void *)&GetPixel(xIdx, yIdx),
+                        &row[column],
+                        count * sizeof(Pixel));
+            xIdx += count;
+        }
+    }
+}
+
+void Canvas::DrawRectangle(const Pixel &color,
+                           const int x,
+                           const int y,
+                           const int width,
+                           const int height) {
+    Fill(color, x, y, width, height);
+}
+
+/* Calls `blit(source, x, y, count)` for the opaque part of each row of
+ * `sprite` at (x, y) that lies within `leftX`, `topY`, `rightX`, and
+ * `bottomY`, skipping transparent margins. */
+template <typename Blit>
+static void ForEachSpan(const Sprite &sprite,
+                        const int x,
+                        const int y,
+                        const int leftX,
+                        const int topY,
+                        const int rightX,
+                        const int bottomY,
+                        Blit blit) {
+    const Pixel *pixels = sprite.Pixels();
+    const Sprite::RowSpan *spans = sprite.Spans();
+
+    for (int yIdx = topY; yIdx < bottomY; yIdx++) {
+        const Sprite::RowSpan &span = spans[yIdx - y];
+        const int rowLeft = std::max(leftX, x + span.Begin);
+        const int rowRight = std::min(rightX, x + span.End);
+
+        if (rowLeft < rowRight) {
+            blit(&pixels[(yIdx - y) * sprite.Width + (rowLeft - x)],
+                 rowLeft,
+                 yIdx,
+                 rowRight - rowLeft);
         }
     }
 }
@@ -155,90 +461,34 @@ void Canvas::DrawCharacter(const Sprite &sprite,
                            const Pixel &fontColor,
                            const int x,
                            const int y) {
-    unsigned pixelIdx = 0, byteIdx = 0;
+    const Pixel *pixels = sprite.Pixels();
 
-    if (!((x < Width) && (y < Height) && (x + sprite.Width >= 0) &&
-          (y + sprite.Height >= 0))) {
+    if (pixels == nullptr) {
         return;
     }
 
-    while (byteIdx < sprite.Size) {
-        int pixelCount;
-
-        /* Skipping over transparent pixels. */
-        pixelIdx += ((uint16_t)sprite.Buffer[byteIdx + 0] << 0x00) |
-                    ((uint16_t)sprite.Buffer[byteIdx + 1] << 0x08);
-        byteIdx += 2;
-
-        /* How many colored pixels follow? */
-        pixelCount = ((uint16_t)sprite.Buffer[byteIdx + 0] << 0x00) |
-                     ((uint16_t)sprite.Buffer[byteIdx + 1] << 0x08);
-        byteIdx += 2;
-
-        while (pixelCount > 0) {
-            /* Where are we currently at in the sprite? */
-            int fromX = pixelIdx % sprite.Width;
-            int fromY = pixelIdx / sprite.Width;
-
-            /* And where on the destination canvas? */
-            int targetX = x + fromX;
-            int targetY = y + fromY;
-
-            if (targetY >= Height) {
-                /* Outside the bottom of the canvas. Nothing to do but
-                 * return. */
-                return;
-            } else if (targetY < 0) {
-                /* Above canvas. Skip what pixels are left in block or until
-                 * we get on canvas. */
-                int skipCount = std::min(sprite.Width - fromX -
-                                                 (1 + targetY) * sprite.Width,
-                                         pixelCount);
-                byteIdx += skipCount * sizeof(Pixel);
-                pixelCount -= skipCount;
-                pixelIdx += skipCount;
-            } else if (targetX >= Width) {
-                /* Right of canvas. Skip what pixels are left in block or
-                 * sprite row. */
-                int skipCount = std::min(sprite.Width - fromX, pixelCount);
-                byteIdx += skipCount * sizeof(Pixel);
-                pixelCount -= skipCount;
-                pixelIdx += skipCount;
-            } else if (targetX < 0) {
-                /* Left of canvas. Skip what pixels are left in block or
-                 * until we get on canvas. */
-                int skipCount = std::min(-targetX, pixelCount);
-                byteIdx += skipCount * sizeof(Pixel);
-                pixelCount -= skipCount;
-                pixelIdx += skipCount;
-            } else {
-                /* On the canvas. Tint with what pixels are left in block or
-                 * until edge of sprite or canvas. */
-                int tintCount =
-                        std::min(std::min(sprite.Width - fromX, pixelCount),
-                                 Width - targetX);
-                int targetIdx = (targetX * sizeof(Pixel)) + (targetY * Stride);
-                unsigned stopIdx = byteIdx + tintCount * sizeof(Pixel);
-
-                while (byteIdx < stopIdx) {
-                    const Pixel &tintKey =
-                            *(Pixel *)&sprite.Buffer[byteIdx + 0];
-                    Pixel &targetPixel = *(Pixel *)&Buffer[targetIdx];
-
-                    targetPixel.Red = (tintKey.Red * fontColor.Red) >> 8;
-                    targetPixel.Green = (tintKey.Green * fontColor.Green) >> 8;
-                    targetPixel.Blue = (tintKey.Blue * fontColor.Blue) >> 8;
-                    targetPixel.Alpha = fontColor.Alpha;
-
-                    targetIdx += sizeof(Pixel);
-                    byteIdx += sizeof(Pixel);
-                }
-
-                pixelCount -= tintCount;
-                pixelIdx += tintCount;
-            }
-        }
+    const int leftX = std::max(x, 0);
+    const int topY = std::max(y, 0);
+    const int rightX = std::min(x + sprite.Width, Width);
+    const int bottomY = std::min(y + sprite.Height, Height);
+
+    if (leftX >= rightX) {
+        return;
     }
+
+    ForEachSpan(sprite,
+                x,
+                y,
+                leftX,
+                topY,
+                rightX,
+                bottomY,
+                [&](const Pixel *source, int rowX, int rowY, int count) {
+                    Blitter::ColorizeMasked(source,
+                                            fontColor,
+                                            &GetPixel(rowX, rowY),
+                                            count);
+                });
 }
 
 void Canvas::Tint(const Sprite &sprite,
@@ -250,154 +500,42 @@ void Canvas::Tint(const Sprite &sprite,
                   const int primary,
                   const int secondary,
                   const int detail) {
-    static unsigned colorMap[] = {
-            0xFFFFFF, 0xFFD4BF, 0xFFE9BF, 0xFFFFBF, 0xE9FFBF, 0xD4FFBF,
-            0xBFFFBF, 0xBFFFD4, 0xBFFFE9, 0xBFFFFF, 0xBFE9FF, 0xBFD4FF,
-            0xBFBFFF, 0xD4BFFF, 0xE9BFFF, 0xFFBFFF, 0xFFBFE9, 0xFFBFD4,
-            0xFFBFBF, 0xDADADA, 0xBF9F8F, 0xBFAF8F, 0xBFBF8F, 0xAFBF8F,
-            0x9FBF8F, 0x8FBF8F, 0x8FBF9F, 0x8FBFAF, 0x8FBFBF, 0x8FAFBF,
-            0x8F9FBF, 0x8F8FBF, 0x9F8FBF, 0xAF8FBF, 0xBF8FBF, 0xBF8FAF,
-            0xBF8F9F, 0xBF8F8F, 0xB6B6B6, 0xBF7F5F, 0xBFAF8F, 0xBFBF5F,
-            0x9FBF5F, 0x7FBF5F, 0x5FBF5F, 0x5FBF7F, 0x5FBF9F, 0x5FBFBF,
-            0x5F9FBF, 0x5F7FBF, 0x5F5FBF, 0x7F5FBF, 0x9F5FBF, 0xBF5FBF,
-            0xBF5F9F, 0xBF5F7F, 0xBF5F5F, 0x919191, 0xBF6A3F, 0xBF943F,
-            0xBFBF3F, 0x94BF3F, 0x6ABF3F, 0x3FBF3F, 0x3FBF6A, 0x3FBF94,
-            0x3FBFBF, 0x3F94BF, 0x3F6ABF, 0x3F3FBF, 0x6A3FBF, 0x943FBF,
-            0xBF3FBF, 0xBF3F94, 0xBF3F6A, 0xBF3F3F, 0x6D6D6D, 0xFF5500,
-            0xFFAA00, 0xFFFF00, 0xAAFF00, 0x54FF00, 0x00FF00, 0x00FF54,
-            0x00FFAA, 0x00FFFF, 0x00A9FF, 0x0055FF, 0x0000FF, 0x5500FF,
-            0xA900FF, 0xFE00FF, 0xFF00AA, 0xFF0055, 0xFF0000, 0x484848,
-            0xBF3F00, 0xBF7F00, 0xBFBF00, 0x7FBF00, 0x3FBF00, 0x00BF00,
-            0x00BF3F, 0x00BF7F, 0x00BFBF, 0x007FBF, 0x003FBF, 0x0000BF,
-            0x3F00BF, 0x7F00BF, 0xBF00BF, 0xBF007F, 0xBF003F, 0xBF0000,
-            0x242424, 0x7F2A00, 0x7F5500, 0x7F7F00, 0x557F00, 0x2A7F00,
-            0x007F00, 0x007F2A, 0x007F55, 0x007F7F, 0x00547F, 0x002A7F,
-            0x00007F, 0x2A007F, 0x54007F, 0x7F007F, 0x7F0055, 0x7F002A,
-            0x7F0000,
-    };
-
-    const unsigned headB = colorMap[head] >> 0 & 255;
-    const unsigned headG = colorMap[head] >> 8 & 255;
-    const unsigned headR = colorMap[head] >> 16 & 255;
-
-    const unsigned primaryB = colorMap[primary] >> 0 & 255;
-    const unsigned primaryG = colorMap[primary] >> 8 & 255;
-    const unsigned primaryR = colorMap[primary] >> 16 & 255;
-
-    const unsigned secondaryB = colorMap[secondary] >> 0 & 255;
-    const unsigned secondaryG = colorMap[secondary] >> 8 & 255;
-    const unsigned secondaryR = colorMap[secondary] >> 16 & 255;
-
-    const unsigned detailB = colorMap[detail] >> 0 & 255;
-    const unsigned detailG = colorMap[detail] >> 8 & 255;
-    const unsigned detailR = colorMap[detail] >> 16 & 255;
-
-    unsigned pixelIdx = 0, byteIdx = 0;
-
-    if (!((x < Width) && (y < Height) && (x + sprite.Width >= 0) &&
-          (y + sprite.Height >= 0))) {
+    const Pixel *pixels = sprite.Pixels();
+
+    if (pixels == nullptr) {
         return;
     }
 
-    while (byteIdx < sprite.Size) {
-        int pixelCount;
-
-        /* Skipping over transparent pixels. */
-        pixelIdx += ((uint16_t)sprite.Buffer[byteIdx + 0] << 0x00) |
-                    ((uint16_t)sprite.Buffer[byteIdx + 1] << 0x08);
-        byteIdx += 2;
-
-        /* How many colored pixels follow? */
-        pixelCount = ((uint16_t)sprite.Buffer[byteIdx + 0] << 0x00) |
-                     ((uint16_t)sprite.Buffer[byteIdx + 1] << 0x08);
-        byteIdx += 2;
-
-        while (pixelCount > 0) {
-            /* Where are we currently at in the sprite? */
-            int fromX = pixelIdx % sprite.Width;
-            int fromY = pixelIdx / sprite.Width;
-
-            /* And where on the destination canvas? */
-            int targetX = x + fromX;
-            int targetY = y + fromY;
-
-            if (targetY >= Height || fromY >= height) {
-                /* Outside the bottom of the canvas. Nothing to do but
-                 * return. */
-                return;
-            } else if (targetY < 0) {
-                /* Above canvas. Skip what pixels are left in block or until
-                 * we get on canvas. */
-                int skipCount = std::min(sprite.Width - fromX -
-                                                 (1 + targetY) * sprite.Width,
-                                         pixelCount);
-                byteIdx += skipCount * sizeof(Pixel);
-                pixelCount -= skipCount;
-                pixelIdx += skipCount;
-            } else if (targetX >= Width || fromX >= width) {
-                /* Right of canvas. Skip what pixels are left in block or
-                 * sprite row.
-                 */
-                int skipCount = std::min(sprite.Width - fromX, pixelCount);
-                byteIdx += skipCount * sizeof(Pixel);
-                pixelCount -= skipCount;
-                pixelIdx += skipCount;
-            } else if (targetX < 0) {
-                /* Left of canvas. Skip what pixels are left in block or
-                 * until we get on canvas. */
-                int skipCount = std::min(-targetX, pixelCount);
-                byteIdx += skipCount * sizeof(Pixel);
-                pixelCount -= skipCount;
-                pixelIdx += skipCount;
-            } else {
-                /* On the canvas. Tint with what pixels are left in block or
-                 * until edge of sprite or canvas. */
-                int tintCount =
-                        std::min(std::min(sprite.Width - fromX, pixelCount),
-                                 Width - targetX);
-                int targetIdx = (targetX * sizeof(Pixel)) + (targetY * Stride);
-                unsigned stopIdx =
-                        byteIdx + std::min(width, tintCount) * sizeof(Pixel);
-
-                while (byteIdx < stopIdx) {
-                    const Pixel &tintKey = *(Pixel *)&sprite.Buffer[byteIdx];
-                    Pixel *targetPixel = (Pixel *)&Buffer[targetIdx];
-
-                    if (tintKey.Red == 0 && tintKey.Green == 0 &&
-                        tintKey.Blue == 0xFF) {
-                        targetPixel->Red = targetPixel->Red * detailR >> 8;
-                        targetPixel->Green = targetPixel->Green * detailG >> 8;
-                        targetPixel->Blue = targetPixel->Blue * detailB >> 8;
-                    } else if (tintKey.Red == 0xFF && tintKey.Green == 0xFF &&
-                               tintKey.Blue == 0) {
-                        targetPixel->Red = targetPixel->Red * headR >> 8;
-                        targetPixel->Green = targetPixel->Green * headG >> 8;
-                        targetPixel->Blue = targetPixel->Blue * headB >> 8;
-                    } else if (tintKey.Red == 0 && tintKey.Green == 0xFF &&
-                               tintKey.Blue == 0) {
-                        targetPixel->Red = targetPixel->Red * secondaryR >> 8;
-                        targetPixel->Green =
-                                targetPixel->Green * secondaryG >> 8;
-                        targetPixel->Blue = targetPixel->Blue * secondaryB >> 8;
-                    } else if (tintKey.Red == 0xFF && tintKey.Green == 0 &&
-                               tintKey.Blue == 0) {
-                        targetPixel->Red = targetPixel->Red * primaryR >> 8;
-                        targetPixel->Green = targetPixel->Green * primaryG >> 8;
-                        targetPixel->Blue = targetPixel->Blue * primaryB >> 8;
-                    }
-
-                    targetIdx += sizeof(Pixel);
-                    byteIdx += sizeof(Pixel);
-                }
-
-                byteIdx += (tintCount - std::min(width, tintCount)) *
-                           sizeof(Pixel);
-
-                pixelCount -= tintCount;
-                pixelIdx += tintCount;
-            }
-        }
+    const Pixel headColor = Pixel::OutfitColor(head);
+    const Pixel primaryColor = Pixel::OutfitColor(primary);
+    const Pixel secondaryColor = Pixel::OutfitColor(secondary);
+    const Pixel detailColor = Pixel::OutfitColor(detail);
+
+    const int leftX = std::max(x, 0);
+    const int topY = std::max(y, 0);
+    const int rightX = std::min({x + sprite.Width, x + width, Width});
+    const int bottomY = std::min({y + sprite.Height, y + height, Height});
+
+    if (leftX >= rightX) {
+        return;
     }
+
+    ForEachSpan(sprite,
+                x,
+                y,
+                leftX,
+                topY,
+                rightX,
+                bottomY,
+                [&](const Pixel *source, int rowX, int rowY, int count) {
+                    Blitter::TintMasked(source,
+                                        headColor,
+                                        primaryColor,
+                                        secondaryColor,
+                                        detailColor,
+                                        &GetPixel(rowX, rowY),
+                                        count);
+                });
 }
 
 void Canvas::Draw(const Sprite &sprite,
@@ -405,90 +543,55 @@ void Canvas::Draw(const Sprite &sprite,
                   const int y,
                   const int width,
                   const int height) {
-    unsigned pixelIdx = 0, byteIdx = 0;
+    /* Clip against the requested bounds as well as the canvas. */
+    const int leftX = std::max(x, 0);
+    const int topY = std::max(y, 0);
+    const int rightX = std::min({x + sprite.Width, x + width, Width});
+    const int bottomY = std::min({y + sprite.Height, y + height, Height});
 
-    if (!((x < Width) && (y < Height) && (x + sprite.Width >= 0) &&
-          (y + sprite.Height >= 0))) {
+    if (leftX >= rightX || topY >= bottomY) {
         return;
     }
 
-    while (byteIdx < sprite.Size) {
-        int pixelCount;
-
-        /* Skipping over transparent pixels. */
-        pixelIdx += ((uint16_t)sprite.Buffer[byteIdx + 0] << 0x00) |
-                    ((uint16_t)sprite.Buffer[byteIdx + 1] << 0x08);
-        byteIdx += 2;
-
-        /* How many colored pixels follow? */
-        pixelCount = ((uint16_t)sprite.Buffer[byteIdx + 0] << 0x00) |
-                     ((uint16_t)sprite.Buffer[byteIdx + 1] << 0x08);
-        byteIdx += 2;
-
-        while (pixelCount > 0) {
-            /* Where are we currently at in the sprite? */
-            int fromX = pixelIdx % sprite.Width;
-            int fromY = pixelIdx / sprite.Width;
-
-            /* And where on the destination canvas? */
-            int targetX = x + fromX;
-            int targetY = y + fromY;
-
-            if (targetY >= Height || fromY >= height) {
-                /* Outside the bottom of the canvas. Nothing to do but
-                 * return. */
-                return;
-            } else if (targetY < 0) {
-                /* Above canvas. Skip what pixels are left in block or until
-                 * we get on canvas. */
-                int skipCount = std::min(sprite.Width - fromX -
-                                                 (1 + targetY) * sprite.Width,
-                                         pixelCount);
-
-                byteIdx += skipCount * sizeof(Pixel);
-                pixelCount -= skipCount;
-                pixelIdx += skipCount;
-            } else if (targetX >= Width || fromX >= width) {
-                /* Right of canvas. Skip what pixels are left in block or
-                 * sprite row.
-                 */
-                int skipCount = std::min(sprite.Width - fromX, pixelCount);
-
-                byteIdx += skipCount * sizeof(Pixel);
-                pixelCount -= skipCount;
-                pixelIdx += skipCount;
-            } else if (targetX < 0) {
-                /* Left of canvas. Skip what pixels are left in block or
-                 * until we get on canvas. */
-                int skipCount = std::min(-targetX, pixelCount);
-
-                byteIdx += skipCount * sizeof(Pixel);
-                pixelCount -= skipCount;
-                pixelIdx += skipCount;
-            } else {
-                /* On the canvas. Copy what pixels are left in block or
-                 * until edge of sprite or canvas. */
-                unsigned destIdx, copyCount;
-
-                copyCount = std::min(std::min(sprite.Width - fromX, pixelCount),
-                                     Width - targetX);
-                destIdx = (targetX * sizeof(Pixel)) + (targetY * Stride);
-
-                Assert(width > 0);
-                memcpy(&Buffer[destIdx],
-                       &sprite.Buffer[byteIdx],
-                       std::min(copyCount, (unsigned)width) * sizeof(Pixel));
-
-                byteIdx += copyCount * sizeof(Pixel);
-                pixelCount -= copyCount;
-                pixelIdx += copyCount;
-            }
+    const Sprite::Coverage coverage = sprite.GetCoverage();
+
+    if (coverage == Sprite::Coverage::Empty) {
+        Blits.Empty++;
+        return;
+    }
+
+    const Pixel *pixels = sprite.Pixels();
+
+    if (coverage == Sprite::Coverage::Opaque) {
+        Blits.Opaque++;
+
+        /* Most ground sprites are solid, so we can copy them row by row
+         * without looking at their alpha. */
+        for (int yIdx = topY; yIdx < bottomY; yIdx++) {
+            std::memcpy((void *)&GetPixel(leftX, yIdx),
+                        &pixels[(yIdx - y) * sprite.Width + (leftX - x)],
+                        (rightX - leftX) * sizeof(Pixel));
         }
+
+        return;
     }
+
+    Blits.Masked++;
+
+    ForEachSpan(sprite,
+                x,
+                y,
+                leftX,
+                topY,
+                rightX,
+                bottomY,
+                [&](const Pixel *source, int rowX, int rowY, int count) {
+                    Blitter::CopyMasked(source, &GetPixel(rowX, rowY), count);
+                });
 }
 
 void Canvas::Wipe() {
-    DrawRectangle(Pixel(0, 0, 0, 0), 0, 0, Width, Height);
+    Fill(Pixel(0, 0, 0, 0), 0, 0, Width, Height);
 }
 
 void Canvas::Dump(const std::filesystem::path &path) const {
@@ -23,6 +23,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 
 #include "pixel.hpp"
 #include "sprites.hpp"
@@ -31,28 +32,74 @@
 
 namespace trc {
 
-/* FIXME: C++ migration, make this a template with a creation/destruction
- * routine so we can plug alternative backends into it. */
+/* A view of 32-bit RGBA pixels with an arbitrary stride.
+ *
+ * The pixel memory is either allocated by the canvas itself, or provided by
+ * an external backend such as an AVFrame, a QImage, or a shared memory
+ * segment. In the latter case the backend's lifetime is tied to the canvas
+ * through an owner handle, whose destruction routine releases the memory once
+ * the canvas and all slices of it are gone. */
 class Canvas {
-    Canvas(int width, int height, int stride, uint8_t *buffer);
+public:
+    enum class Type { Internal, External, Slice };
+
+private:
+    /* Keeps the pixel memory alive, shared with all slices of this canvas.
+     * Empty for external canvases whose memory is managed by the caller. */
+    std::shared_ptr<const void> Owner;
+
+    Canvas(int width,
+           int height,
+           int stride,
+           uint8_t *buffer,
+           std::shared_ptr<const void> owner,
+           Type kind);
 
 public:
-    enum class Type { Internal, External, Slice } Kind;
+    Type Kind;
 
     int Width;
     int Height;
     int Stride;
     uint8_t *Buffer;
 
+    /* Number of sprites drawn through each path in Draw, for profiling, not
+     * counting those that were clipped away entirely. These are never reset
+     * by the canvas itself, so callers that want per-frame figures need to
+     * clear them between frames. Slices count on their own. */
+    struct BlitStatistics {
+        uint64_t Empty;
+        uint64_t Opaque;
+        uint64_t Masked;
+
+        BlitStatistics &operator+=(const BlitStatistics &other) {
+            Empty += other.Empty;
+            Opaque += other.Opaque;
+            Masked += other.Masked;
+            return *this;
+        }
+    } Blits;
+
+    /* Creates a canvas with memory of its own, or an external canvas whose
+     * `Buffer` and `Stride` are to be filled in by the caller. */
     Canvas(int width, int height, Type kind = Type::Internal);
-    ~Canvas();
+
+    /* Wraps external memory laid out with the given stride. If given, `owner`
+     * is kept alive for as long as the canvas or any slice of it, and can be
+     * any handle that releases the memory on destruction. */
+    Canvas(int width,
+           int height,
+           int stride,
+           uint8_t *buffer,
+           std::shared_ptr<const void> owner = nullptr);
 
     Canvas(const Canvas &other) = delete;
 
     /* Creates a sub-canvas referring to a part of the original canvas, useful
      * for rendering within certain bounds like the game viewport.
      *
-     * The sub-canvas does not need to be freed. */
+     * The sub-canvas keeps the memory of the original alive, and may outlive
+     * it. */
     const Canvas Slice(int leftX, int topY, int rightX, int bottomY);
 
     void Wipe();
@@ -70,6 +117,39 @@ public:
         return *(const Pixel *)&Buffer[offset + (y * Stride)];
     }
 
+    /* Fills the given rectangle with `color`, clipped to the canvas. */
+    void Fill(const Pixel &color, int x, int y, int width, int height);
+
+    /* Copies the given rectangle of `source` to (x, y), clipped to both
+     * canvases. The two areas must not overlap. */
+    void Blit(const Canvas &source,
+              int sourceX,
+              int sourceY,
+              int x,
+              int y,
+              int width,
+              int height);
+
+    /* Like Blit, but only copies the opaque pixels of `source`, leaving the
+     * rest of the rectangle as-is. */
+    void Composite(const Canvas &source,
+                   int sourceX,
+                   int sourceY,
+                   int x,
+                   int y,
+                   int width,
+                   int height);
+
+    /* Tiles the given rectangle with `sprite`, starting at its top-left
+     * corner and clipped to the canvas. */
+    void TileFill(const Sprite &sprite, int x, int y, int width, int height);
+
+    /* Stretches all of `source` over the given rectangle, which must lie
+     * within the canvas. When the rectangle is a whole multiple of `source`
+     * in size its pixels are repeated as-is, otherwise it's filtered
+     * bilinearly. */
+    void Scale(const Canvas &source, int x, int y, int width, int height);
+
     void DrawRectangle(const Pixel &color, int x, int y, int width, int height);
 
     void DrawCharacter(const Sprite &sprite,
@@ -69,7 +69,7 @@ static const std::string Windows1252ToUtf8[128] = {
         {{-61, -69}, 2},        {{-61, -68}, 2},        {{-61, -67}, 2},
         {{-61, -66}, 2},        {{-61, -65}, 2}};
 
-std::string ToPrintableUtf8(const std::string &text) {
+std::string ToPrintableUtf8(std::string_view text) {
     std::stringstream result;
 
     for (auto character : text) {
@@ -83,7 +83,7 @@ std::string ToPrintableUtf8(const std::string &text) {
     return result.str();
 }
 
-std::string ToUtf8(const std::string &text) {
+std::string ToUtf8(std::string_view text) {
     std::stringstream result;
 
     for (auto character : text) {
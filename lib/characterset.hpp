@@ -23,6 +23,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace trc {
 namespace CharacterSet {
@@ -96,8 +97,8 @@ inline uint8_t ToPrintable(uint8_t c) {
     return c;
 }
 
-std::string ToPrintableUtf8(const std::string &text);
-std::string ToUtf8(const std::string &text);
+std::string ToPrintableUtf8(std::string_view text);
+std::string ToUtf8(std::string_view text);
 }; // namespace CharacterSet
 }; // namespace trc
 
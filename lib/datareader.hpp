@@ -29,6 +29,7 @@
 #include <type_traits>
 #include <limits>
 #include <string>
+#include <string_view>
 #include <bit>
 
 #include "utils.hpp"
@@ -153,9 +154,10 @@ public:
         return result;
     }
 
-    template <
-            typename T,
-            std::enable_if_t<std::is_same<T, std::string>::value, bool> = true>
+    template <typename T,
+              std::enable_if_t<std::is_same<T, std::string>::value ||
+                                       std::is_same<T, std::string_view>::value,
+                               bool> = true>
     T Read() {
         auto count = Read<uint16_t>();
 
@@ -208,6 +210,12 @@ public:
         return Read<std::string>();
     }
 
+    /* As above, but without copying the string out of the underlying data,
+     * for when it will be copied elsewhere regardless. */
+    std::string_view ReadStringView() {
+        return Read<std::string_view>();
+    }
+
     void SkipString() {
         (void)Read<std::string>();
     }
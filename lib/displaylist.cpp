@@ -0,0 +1,371 @@
+/*
+ * Copyright 2025 "John Högberg"
+ *
+ * This file is part of tibiarc.
+ *
+ * tibiarc is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * tibiarc is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with tibiarc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "displaylist.hpp"
+
+#include "utils.hpp"
+
+#include <algorithm>
+
+#ifndef DISABLE_THREADS
+#    include <atomic>
+#    include <condition_variable>
+#    include <functional>
+#    include <mutex>
+#    include <thread>
+#endif
+
+namespace trc {
+
+/* Lists shorter than this are cheaper to draw directly than to hand off to
+ * other threads. */
+static constexpr size_t ParallelThreshold = 256;
+
+/* The bins are small enough that more threads than this mostly fight over
+ * memory bandwidth. */
+static constexpr unsigned MaxThreads = 8;
+
+#ifndef DISABLE_THREADS
+/* A fixed set of threads that run the same job together with the thread that
+ * hands it out, started the first time a list is big enough to need them. */
+struct DisplayList::Workers {
+    std::mutex Lock;
+    std::condition_variable Wake;
+    std::condition_variable Done;
+    std::vector<std::thread> Threads;
+
+    std::function<void()> Job;
+    uint64_t Generation = 0;
+    size_t Active = 0;
+    bool Quit = false;
+
+    Workers(unsigned count) {
+        for (unsigned i = 0; i < count; i++) {
+            Threads.emplace_back([this]() { Loop(); });
+        }
+    }
+
+    ~Workers() {
+        {
+            std::lock_guard<std::mutex> guard(Lock);
+            Quit = true;
+        }
+
+        Wake.notify_all();
+
+        for (auto &thread : Threads) {
+            thread.join();
+        }
+    }
+
+    void Loop() {
+        std::unique_lock<std::mutex> guard(Lock);
+        uint64_t seen = 0;
+
+        for (;;) {
+            Wake.wait(guard, [&]() { return Quit || Generation != seen; });
+
+            if (Quit) {
+                return;
+            }
+
+            seen = Generation;
+
+            guard.unlock();
+            Job();
+            guard.lock();
+
+            if (--Active == 0) {
+                Done.notify_one();
+            }
+        }
+    }
+
+    /* Runs `job` on all threads, including the calling one, returning when
+     * all of them are done with it. */
+    void Run(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> guard(Lock);
+            Job = std::move(job);
+            Active = Threads.size();
+            Generation++;
+        }
+
+        Wake.notify_all();
+        Job();
+
+        std::unique_lock<std::mutex> guard(Lock);
+        Done.wait(guard, [&]() { return Active == 0; });
+    }
+};
+#else
+struct DisplayList::Workers {};
+#endif
+
+DisplayList::DisplayList() : Width(0), Height(0) {
+}
+
+DisplayList::~DisplayList() = default;
+
+DisplayList::DisplayList(DisplayList &&other) = default;
+DisplayList &DisplayList::operator=(DisplayList &&other) = default;
+
+void DisplayList::Reset(int width, int height) {
+    Width = width;
+    Height = height;
+
+    Commands.clear();
+    Retained.clear();
+}
+
+void DisplayList::Add(const Command &command) {
+    /* Skip draws that are clipped away entirely, as there are quite a few of
+     * them along the edges of the map. */
+    if (command.X >= Width || command.Y >= Height ||
+        command.X + command.Width <= 0 || command.Y + command.Height <= 0 ||
+        command.Width <= 0 || command.Height <= 0) {
+        return;
+    }
+
+    Commands.push_back(command);
+}
+
+void DisplayList::Fill(const Pixel &color,
+                       int x,
+                       int y,
+                       int width,
+                       int height) {
+    Add(Command{.Type = Kind::Fill,
+                .Color = color,
+                .X = x,
+                .Y = y,
+                .Width = width,
+                .Height = height});
+}
+
+void DisplayList::Blit(const Canvas &source,
+                       int sourceX,
+                       int sourceY,
+                       int x,
+                       int y,
+                       int width,
+                       int height) {
+    Add(Command{.Type = Kind::Blit,
+                .Source = &source,
+                .SourceX = sourceX,
+                .SourceY = sourceY,
+                .X = x,
+                .Y = y,
+                .Width = width,
+                .Height = height});
+}
+
+void DisplayList::Composite(const Canvas &source,
+                            int sourceX,
+                            int sourceY,
+                            int x,
+                            int y,
+                            int width,
+                            int height) {
+    Add(Command{.Type = Kind::Composite,
+                .Source = &source,
+                .SourceX = sourceX,
+                .SourceY = sourceY,
+                .X = x,
+                .Y = y,
+                .Width = width,
+                .Height = height});
+}
+
+void DisplayList::Draw(const trc::Sprite &sprite,
+                       int x,
+                       int y,
+                       int width,
+                       int height) {
+    if (sprite.GetCoverage() == Sprite::Coverage::Empty) {
+        return;
+    }
+
+    Add(Command{.Type = Kind::Draw,
+                .Sprite = &sprite,
+                .X = x,
+                .Y = y,
+                .Width = std::min(width, sprite.Width),
+                .Height = std::min(height, sprite.Height)});
+}
+
+void DisplayList::Tint(const trc::Sprite &sprite,
+                       int x,
+                       int y,
+                       int width,
+                       int height,
+                       int head,
+                       int primary,
+                       int secondary,
+                       int detail) {
+    Add(Command{.Type = Kind::Tint,
+                .Head = (uint8_t)head,
+                .Primary = (uint8_t)primary,
+                .Secondary = (uint8_t)secondary,
+                .Detail = (uint8_t)detail,
+                .Sprite = &sprite,
+                .X = x,
+                .Y = y,
+                .Width = std::min(width, sprite.Width),
+                .Height = std::min(height, sprite.Height)});
+}
+
+void DisplayList::Retain(std::shared_ptr<const void> handle) {
+    Retained.push_back(std::move(handle));
+}
+
+void DisplayList::Execute(const Command &command,
+                          Canvas &canvas,
+                          int offsetX,
+                          int offsetY) {
+    const int x = command.X - offsetX;
+    const int y = command.Y - offsetY;
+
+    switch (command.Type) {
+    case Kind::Fill:
+        canvas.Fill(command.Color, x, y, command.Width, command.Height);
+        break;
+    case Kind::Blit:
+        canvas.Blit(*command.Source,
+                    command.SourceX,
+                    command.SourceY,
+                    x,
+                    y,
+                    command.Width,
+                    command.Height);
+        break;
+    case Kind::Composite:
+        canvas.Composite(*command.Source,
+                         command.SourceX,
+                         command.SourceY,
+                         x,
+                         y,
+                         command.Width,
+                         command.Height);
+        break;
+    case Kind::Draw:
+        canvas.Draw(*command.Sprite, x, y, command.Width, command.Height);
+        break;
+    case Kind::Tint:
+        canvas.Tint(*command.Sprite,
+                    x,
+                    y,
+                    command.Width,
+                    command.Height,
+                    command.Head,
+                    command.Primary,
+                    command.Secondary,
+                    command.Detail);
+        break;
+    }
+}
+
+void DisplayList::Rasterize(Canvas &canvas) {
+    AbortUnless(canvas.Width == Width && canvas.Height == Height);
+
+    const int columns = (Width + BinSize - 1) / BinSize;
+    const int rows = (Height + BinSize - 1) / BinSize;
+
+#ifndef DISABLE_THREADS
+    const unsigned threads =
+            std::clamp(std::thread::hardware_concurrency(), 1u, MaxThreads);
+
+    if (threads > 1 && Commands.size() >= ParallelThreshold &&
+        columns * rows > 1) {
+        if (!Pool) {
+            Pool = std::make_unique<Workers>(threads - 1);
+        }
+
+        Bins.resize(columns * rows);
+
+        for (auto &bin : Bins) {
+            bin.clear();
+        }
+
+        /* Add the commands in order, keeping the painter's order within each
+         * bin. */
+        for (uint32_t index = 0; index < Commands.size(); index++) {
+            const Command &command = Commands[index];
+
+            const int leftX = std::max(command.X, 0) / BinSize;
+            const int topY = std::max(command.Y, 0) / BinSize;
+            const int rightX =
+                    (std::min(command.X + command.Width, Width) - 1) / BinSize;
+            const int bottomY =
+                    (std::min(command.Y + command.Height, Height) - 1) /
+                    BinSize;
+
+            for (int binY = topY; binY <= bottomY; binY++) {
+                for (int binX = leftX; binX <= rightX; binX++) {
+                    Bins[binY * columns + binX].push_back(index);
+                }
+            }
+        }
+
+        std::atomic<int> next(0);
+        std::mutex statisticsLock;
+
+        Pool->Run([&]() {
+            Canvas::BlitStatistics blits{};
+
+            for (;;) {
+                const int bin = next.fetch_add(1, std::memory_order_relaxed);
+
+                if (bin >= columns * rows) {
+                    break;
+                }
+
+                const int leftX = (bin % columns) * BinSize;
+                const int topY = (bin / columns) * BinSize;
+                Canvas slice = canvas.Slice(leftX,
+                                            topY,
+                                            std::min(leftX + BinSize, Width),
+                                            std::min(topY + BinSize, Height));
+
+                for (uint32_t index : Bins[bin]) {
+                    Execute(Commands[index], slice, leftX, topY);
+                }
+
+                blits += slice.Blits;
+            }
+
+            /* Slices count on their own, so add theirs to the canvas we were
+             * asked to draw on. */
+            std::lock_guard<std::mutex> guard(statisticsLock);
+            canvas.Blits += blits;
+        });
+
+        return;
+    }
+#else
+    (void)columns;
+    (void)rows;
+#endif
+
+    for (const auto &command : Commands) {
+        Execute(command, canvas, 0, 0);
+    }
+}
+
+} // namespace trc
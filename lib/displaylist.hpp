@@ -0,0 +1,141 @@
+/*
+ * Copyright 2025 "John Högberg"
+ *
+ * This file is part of tibiarc.
+ *
+ * tibiarc is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * tibiarc is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with tibiarc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TRC_DISPLAYLIST_HPP__
+#define __TRC_DISPLAYLIST_HPP__
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "canvas.hpp"
+#include "pixel.hpp"
+#include "sprites.hpp"
+
+namespace trc {
+
+/* Records draws against a canvas of a given size, in painter's order, so that
+ * they can be rasterized later on by several threads at once. This mirrors
+ * the drawing functions of Canvas, letting code that is templated on its
+ * target draw into either.
+ *
+ * Rasterizing splits the canvas into bins of `BinSize` pixels square, each
+ * holding the draws that overlap it in the order they were made. As draws
+ * are clipped to their bins, the bins can be drawn independently of each
+ * other by a pool of worker threads. Short lists are drawn as-is on the
+ * calling thread, as are all lists when threads are disabled.
+ *
+ * Everything drawn from, sprites and canvases alike, must stay alive and
+ * unchanged until the list has been rasterized. */
+class DisplayList {
+public:
+    static constexpr int BinSize = 64;
+
+    int Width;
+    int Height;
+
+    DisplayList();
+    ~DisplayList();
+
+    DisplayList(DisplayList &&other);
+    DisplayList &operator=(DisplayList &&other);
+
+    DisplayList(const DisplayList &other) = delete;
+
+    /* Starts over with a canvas of the given size, forgetting all draws. */
+    void Reset(int width, int height);
+
+    void Fill(const Pixel &color, int x, int y, int width, int height);
+
+    void Blit(const Canvas &source,
+              int sourceX,
+              int sourceY,
+              int x,
+              int y,
+              int width,
+              int height);
+
+    void Composite(const Canvas &source,
+                   int sourceX,
+                   int sourceY,
+                   int x,
+                   int y,
+                   int width,
+                   int height);
+
+    void Draw(const Sprite &sprite, int x, int y, int width, int height);
+
+    void Tint(const Sprite &sprite,
+              int x,
+              int y,
+              int width,
+              int height,
+              int head,
+              int primary,
+              int secondary,
+              int detail);
+
+    /* Keeps `handle` alive until the list is reset, for draws of sprites
+     * that would otherwise be released before the list is rasterized, such
+     * as those of evicted TintCache entries. */
+    void Retain(std::shared_ptr<const void> handle);
+
+    /* Draws the list onto `canvas`, which must be of the size given to
+     * Reset(). */
+    void Rasterize(Canvas &canvas);
+
+private:
+    enum class Kind : uint8_t { Fill, Blit, Composite, Draw, Tint };
+
+    struct Command {
+        Kind Type;
+        uint8_t Head = 0;
+        uint8_t Primary = 0;
+        uint8_t Secondary = 0;
+        uint8_t Detail = 0;
+        Pixel Color = Pixel(0, 0, 0, 0);
+        const trc::Sprite *Sprite = nullptr;
+        const Canvas *Source = nullptr;
+        int SourceX = 0;
+        int SourceY = 0;
+        int X;
+        int Y;
+        int Width;
+        int Height;
+    };
+
+    std::vector<Command> Commands;
+    std::vector<std::shared_ptr<const void>> Retained;
+
+    /* Indexes into `Commands`, per bin. */
+    std::vector<std::vector<uint32_t>> Bins;
+
+    struct Workers;
+    std::unique_ptr<Workers> Pool;
+
+    void Add(const Command &command);
+    static void Execute(const Command &command,
+                        Canvas &canvas,
+                        int offsetX,
+                        int offsetY);
+};
+
+} // namespace trc
+
+#endif /* __TRC_DISPLAYLIST_HPP__ */
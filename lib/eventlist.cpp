@@ -0,0 +1,54 @@
+/*
+ * Copyright 2025 "John Högberg"
+ *
+ * This file is part of tibiarc.
+ *
+ * tibiarc is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * tibiarc is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with tibiarc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "eventlist.hpp"
+
+namespace trc {
+namespace Events {
+
+List::List()
+    : Arena(std::make_unique<std::pmr::monotonic_buffer_resource>(
+              sizeof(Block))) {
+    Head = Tail = new (Arena->allocate(sizeof(Block), alignof(Block))) Block;
+}
+
+void List::NextBlock() {
+    if (Tail->Next == nullptr) {
+        Tail->Next =
+                new (Arena->allocate(sizeof(Block), alignof(Block))) Block;
+    }
+
+    Tail = Tail->Next;
+    Assert(Tail->Used == 0);
+}
+
+void List::Truncate(Iterator position) {
+    Tail = const_cast<Block *>(position.Current);
+
+    /* The blocks past `position` only hold events that we're forgetting, keep
+     * them around for those to come. */
+    for (Block *block = Tail->Next; block != nullptr; block = block->Next) {
+        block->Used = 0;
+    }
+
+    Tail->Used = position.Offset;
+}
+
+} // namespace Events
+} // namespace trc
@@ -0,0 +1,246 @@
+/*
+ * Copyright 2025 "John Högberg"
+ *
+ * This file is part of tibiarc.
+ *
+ * tibiarc is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * tibiarc is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with tibiarc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TRC_EVENTLIST_HPP__
+#define __TRC_EVENTLIST_HPP__
+
+#include "events.hpp"
+#include "utils.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace trc {
+namespace Events {
+
+/* Stores events back to back in large blocks, rather than allocating each of
+ * them on its own, so that the events of a long recording are replayed from
+ * a handful of contiguous buffers.
+ *
+ * The blocks, as well as everything the events allocate, come from a
+ * monotonic arena owned by the list. Events are never destroyed; the arena is
+ * released as a whole when the list is, no matter how many events it holds.
+ *
+ * Events can only be added at the end, and stay where they are until the list
+ * is truncated before them or destroyed. Hence iterators and ranges remain
+ * valid as more events are added, even when the list itself is moved. */
+class List {
+    struct Block;
+
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Base;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Base *;
+        using reference = const Base &;
+
+        Iterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const {
+            return &**this;
+        }
+
+        Iterator &operator++();
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const Iterator &other) const = default;
+
+    private:
+        friend class List;
+
+        /* Positions taken at the end of the list may point just past the
+         * last entry of their block, and are only moved along to the next
+         * block once dereferenced or incremented. This keeps them equal to
+         * iterators that reach them from earlier events, regardless of
+         * whether another block has been added in the meantime. */
+        const Block *Current = nullptr;
+        uint32_t Offset = 0;
+
+        Iterator(const Block *block, uint32_t offset)
+            : Current(block), Offset(offset) {
+        }
+    };
+
+    List();
+
+    List(List &&other) = default;
+    List &operator=(List &&other) = default;
+
+    List(const List &other) = delete;
+
+    Iterator begin() const {
+        return Iterator(Head, 0);
+    }
+
+    Iterator end() const {
+        return Iterator(Tail, Tail->Used);
+    }
+
+    std::pmr::memory_resource *GetResource() const {
+        return Arena.get();
+    }
+
+    template <typename T, typename... Args> T &Emplace(Args &&...args) {
+        static_assert(std::is_base_of_v<Base, T>);
+        static_assert(alignof(T) <= EntryAlignment);
+
+        constexpr size_t size =
+                (HeaderSize + sizeof(T) + EntryAlignment - 1) &
+                ~(EntryAlignment - 1);
+        static_assert(size <= BlockSize);
+
+        std::byte *entry = Reserve(size);
+        T *event = std::uninitialized_construct_using_allocator(
+                reinterpret_cast<T *>(entry + HeaderSize),
+                std::pmr::polymorphic_allocator<>(Arena.get()),
+                std::forward<Args>(args)...);
+
+        /* Iterators find the event through its base class, which must thus
+         * sit at the start of the entry. */
+        Assert(static_cast<void *>(static_cast<Base *>(event)) ==
+               static_cast<void *>(event));
+
+        Commit(size);
+
+        return *event;
+    }
+
+    /* Forgets all events from `position` onwards. Their memory is not
+     * reclaimed until the list is destroyed, but the blocks they were in are
+     * reused for the events added after this. */
+    void Truncate(Iterator position);
+
+private:
+    static constexpr size_t BlockSize = 64 << 10;
+    static constexpr size_t EntryAlignment = 8;
+    static constexpr size_t HeaderSize = EntryAlignment;
+
+    struct Block {
+        Block *Next = nullptr;
+        uint32_t Used = 0;
+
+        alignas(EntryAlignment) std::byte Data[BlockSize];
+    };
+
+    /* Each entry starts with its size, followed by the event itself. */
+    static uint32_t &EntrySize(std::byte *entry) {
+        return *std::launder(reinterpret_cast<uint32_t *>(entry));
+    }
+
+    static uint32_t EntrySize(const std::byte *entry) {
+        return *std::launder(reinterpret_cast<const uint32_t *>(entry));
+    }
+
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> Arena;
+    Block *Head = nullptr;
+    Block *Tail = nullptr;
+
+    std::byte *Reserve(size_t size) {
+        if ((BlockSize - Tail->Used) < size) {
+            NextBlock();
+        }
+
+        return &Tail->Data[Tail->Used];
+    }
+
+    void Commit(size_t size) {
+        EntrySize(&Tail->Data[Tail->Used]) = static_cast<uint32_t>(size);
+        Tail->Used += static_cast<uint32_t>(size);
+    }
+
+    void NextBlock();
+};
+
+/* A span of events within a List, such as those of a single frame. */
+class Range {
+public:
+    Range() = default;
+    Range(List::Iterator first, List::Iterator last)
+        : First(first), Last(last) {
+    }
+
+    List::Iterator begin() const {
+        return First;
+    }
+
+    List::Iterator end() const {
+        return Last;
+    }
+
+    bool empty() const {
+        return First == Last;
+    }
+
+    /* Grows the range to include `next`, which must follow immediately after
+     * it. */
+    void Extend(const Range &next) {
+        if (empty()) {
+            *this = next;
+        } else if (!next.empty()) {
+            AbortUnless(Last == next.First);
+            Last = next.Last;
+        }
+    }
+
+private:
+    List::Iterator First;
+    List::Iterator Last;
+};
+
+inline List::Iterator::reference List::Iterator::operator*() const {
+    const Block *block = Current;
+    uint32_t offset = Offset;
+
+    if (offset == block->Used) {
+        block = block->Next;
+        offset = 0;
+    }
+
+    return *std::launder(reinterpret_cast<const Base *>(
+            &block->Data[offset + HeaderSize]));
+}
+
+inline List::Iterator &List::Iterator::operator++() {
+    if (Offset == Current->Used) {
+        Current = Current->Next;
+        Offset = 0;
+    }
+
+    Offset += EntrySize(&Current->Data[Offset]);
+
+    return *this;
+}
+
+} // namespace Events
+} // namespace trc
+
+#endif /* __TRC_EVENTLIST_HPP__ */
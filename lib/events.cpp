@@ -59,24 +59,30 @@ void TileUpdated::Update(Gamestate &gamestate) const {
     for (int i = 0; i < tile.ObjectCount; i++) {
         tile.Objects[i] = Objects[i];
     }
+
+    tile.UpdateFlags(gamestate.Version);
+    gamestate.Map.Touch(Position);
 }
 
 void TileObjectAdded::Update(Gamestate &gamestate) const {
     auto &tile = gamestate.Map.Tile(TilePosition);
 
     tile.InsertObject(gamestate.Version, Object, StackPosition);
+    gamestate.Map.Touch(TilePosition);
 }
 
 void TileObjectTransformed::Update(Gamestate &gamestate) const {
     auto &tile = gamestate.Map.Tile(TilePosition);
 
     tile.SetObject(gamestate.Version, Object, StackPosition);
+    gamestate.Map.Touch(TilePosition);
 }
 
 void TileObjectRemoved::Update(Gamestate &gamestate) const {
     auto &tile = gamestate.Map.Tile(TilePosition);
 
     tile.RemoveObject(gamestate.Version, StackPosition);
+    gamestate.Map.Touch(TilePosition);
 }
 
 void CreatureMoved::Update(Gamestate &gamestate) const {
@@ -95,6 +101,7 @@ void CreatureMoved::Update(Gamestate &gamestate) const {
         creatureId = movedObject.CreatureId;
 
         fromTile.RemoveObject(version, StackPosition);
+        gamestate.Map.Touch(From);
     } else {
         creatureId = CreatureId;
     }
@@ -137,7 +144,7 @@ void CreatureMoved::Update(Gamestate &gamestate) const {
         auto &groundObject = toTile.GetObject(gamestate.Version, 0);
         uint32_t movementSpeed;
 
-        const auto &groundType = version.GetItem(groundObject.Id);
+        const auto &groundType = version.GetItem(groundObject);
         if (groundType.Properties.StackPriority != 0) {
             throw InvalidDataError();
         }
@@ -172,6 +179,7 @@ void CreatureMoved::Update(Gamestate &gamestate) const {
     movedObject.CreatureId = creatureId;
 
     toTile.InsertObject(gamestate.Version, movedObject, Tile::StackPositionTop);
+    gamestate.Map.Touch(To);
 }
 
 void CreatureRemoved::Update(Gamestate &gamestate) const {
@@ -206,6 +214,10 @@ void CreatureSeen::Update(Gamestate &gamestate) const {
     creature.Mark = Mark;
     creature.MarkIsPermanent = MarkIsPermanent;
     creature.GuildMembersOnline = GuildMembersOnline;
+
+    if (CreatureId == gamestate.Player.Id) {
+        gamestate.InterfaceGeneration++;
+    }
 }
 
 void CreatureHealthUpdated::Update(Gamestate &gamestate) const {
@@ -243,6 +255,10 @@ void CreatureSkullUpdated::Update(Gamestate &gamestate) const {
     auto &creature = gamestate.GetCreature(CreatureId);
 
     creature.Skull = Skull;
+
+    if (CreatureId == gamestate.Player.Id) {
+        gamestate.InterfaceGeneration++;
+    }
 }
 
 void CreatureShieldUpdated::Update(Gamestate &gamestate) const {
@@ -284,6 +300,7 @@ void CreatureNPCCategoryUpdated::Update(Gamestate &gamestate) const {
 
 void PlayerInventoryUpdated::Update(Gamestate &gamestate) const {
     gamestate.Player.Inventory(Slot) = Item;
+    gamestate.InterfaceGeneration++;
 }
 
 void PlayerBlessingsUpdated::Update(Gamestate &gamestate) const {
@@ -323,6 +340,8 @@ void PlayerDataUpdated::Update(Gamestate &gamestate) const {
     stats.SoulPoints = SoulPoints;
     stats.Speed = Speed;
     stats.Stamina = Stamina;
+
+    gamestate.InterfaceGeneration++;
 }
 
 void PlayerSkillsUpdated::Update(Gamestate &gamestate) const {
@@ -333,10 +352,13 @@ void PlayerSkillsUpdated::Update(Gamestate &gamestate) const {
         player.Skills[i].Actual = Skills[i].Actual;
         player.Skills[i].Percent = Skills[i].Percent;
     }
+
+    gamestate.InterfaceGeneration++;
 }
 
 void PlayerIconsUpdated::Update(Gamestate &gamestate) const {
     gamestate.Player.Icons = Icons;
+    gamestate.InterfaceGeneration++;
 }
 
 void PlayerTacticsUpdated::Update(Gamestate &gamestate) const {
@@ -397,12 +419,15 @@ void ContainerOpened::Update(Gamestate &gamestate) const {
     container.Pagination = Pagination;
     container.TotalObjects = TotalObjects;
     container.StartIndex = StartIndex;
-    container.Items = Items;
+    container.Items.assign(Items.cbegin(), Items.cend());
+
+    gamestate.InterfaceGeneration++;
 }
 
 void ContainerClosed::Update(Gamestate &gamestate) const {
     /* It's fine to close a non-existing container. */
     (void)gamestate.Containers.erase(ContainerId);
+    gamestate.InterfaceGeneration++;
 }
 
 void ContainerAddedItem::Update(Gamestate &gamestate) const {
@@ -418,6 +443,8 @@ void ContainerAddedItem::Update(Gamestate &gamestate) const {
         }
 
         container.TotalObjects += 1;
+
+        gamestate.InterfaceGeneration++;
     }
 }
 
@@ -434,6 +461,8 @@ void ContainerTransformedItem::Update(Gamestate &gamestate) const {
                 container.Items[transformAt] = Item;
             }
         }
+
+        gamestate.InterfaceGeneration++;
     }
 }
 
@@ -457,6 +486,8 @@ void ContainerRemovedItem::Update(Gamestate &gamestate) const {
         }
 
         container.TotalObjects--;
+
+        gamestate.InterfaceGeneration++;
     }
 }
 
@@ -470,6 +501,7 @@ void GraphicalEffectPopped::Update(Gamestate &gamestate) const {
     auto &tile = gamestate.Map.Tile(Position);
 
     tile.AddGraphicalEffect(Id, gamestate.CurrentTick);
+    gamestate.Map.UpdateOccupancy(Position);
 }
 
 void MissileFired::Update(Gamestate &gamestate) const {
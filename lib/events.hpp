@@ -22,6 +22,9 @@
 
 #include "gamestate.hpp"
 
+#include <memory_resource>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace trc {
@@ -79,6 +82,11 @@ enum class Type {
     StatusMessageReceivedInChannel
 };
 
+/* Events live in the arena of an Events::List and are never destroyed, the
+ * arena being released as a whole instead. Hence any memory they own must
+ * come from the arena too: members that allocate must be `std::pmr`
+ * containers, and events that have them must accept an `allocator_type` on
+ * construction and pass it on to their members. */
 struct Base {
     virtual void Update(trc::Gamestate &gamestate) const = 0;
     virtual Events::Type Kind() const = 0;
@@ -113,9 +121,15 @@ struct AmbientLightChanged : public Base {
 };
 
 struct TileUpdated : public Base {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
     trc::Position Position;
 
-    std::vector<Object> Objects;
+    std::pmr::vector<Object> Objects;
+
+    explicit TileUpdated(const allocator_type &allocator = {})
+        : Objects(allocator) {
+    }
 
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
@@ -180,10 +194,12 @@ struct CreatureRemoved : public Base {
 };
 
 struct CreatureSeen : public Base {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
     uint32_t CreatureId;
 
     CreatureType Type;
-    std::string Name;
+    std::pmr::string Name;
     uint8_t Health;
     Creature::Direction Heading;
     Appearance Outfit;
@@ -202,6 +218,10 @@ struct CreatureSeen : public Base {
 
     bool Impassable = true;
 
+    explicit CreatureSeen(const allocator_type &allocator = {})
+        : Name(allocator) {
+    }
+
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
         return Events::Type::CreatureSeen;
@@ -388,11 +408,17 @@ struct PlayerHotkeyPresetUpdated : public Base {
 };
 
 struct PlayerDataBasicUpdated : public Base {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
     bool IsPremium;
 
     uint32_t PremiumUntil = 0;
     uint8_t Vocation;
-    std::vector<uint16_t> Spells;
+    std::pmr::vector<uint16_t> Spells;
+
+    explicit PlayerDataBasicUpdated(const allocator_type &allocator = {})
+        : Spells(allocator) {
+    }
 
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
@@ -470,13 +496,19 @@ struct PvPSituationsChanged : public Base {
 };
 
 struct CreatureSpoke : public Base {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
     uint32_t MessageId;
     MessageMode Mode;
 
-    std::string AuthorName;
+    std::pmr::string AuthorName;
     uint16_t AuthorLevel;
 
-    std::string Message;
+    std::pmr::string Message;
+
+    explicit CreatureSpoke(const allocator_type &allocator = {})
+        : AuthorName(allocator), Message(allocator) {
+    }
 
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
@@ -487,6 +519,10 @@ struct CreatureSpoke : public Base {
 struct CreatureSpokeOnMap : public CreatureSpoke {
     trc::Position Position;
 
+    explicit CreatureSpokeOnMap(const allocator_type &allocator = {})
+        : CreatureSpoke(allocator) {
+    }
+
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
         return Events::Type::CreatureSpokeOnMap;
@@ -496,6 +532,10 @@ struct CreatureSpokeOnMap : public CreatureSpoke {
 struct CreatureSpokeInChannel : public CreatureSpoke {
     uint16_t ChannelId;
 
+    explicit CreatureSpokeInChannel(const allocator_type &allocator = {})
+        : CreatureSpoke(allocator) {
+    }
+
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
         return Events::Type::CreatureSpokeInChannel;
@@ -503,7 +543,13 @@ struct CreatureSpokeInChannel : public CreatureSpoke {
 };
 
 struct ChannelListUpdated : public Base {
-    std::vector<std::pair<uint16_t, std::string>> Channels;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    std::pmr::vector<std::pair<uint16_t, std::pmr::string>> Channels;
+
+    explicit ChannelListUpdated(const allocator_type &allocator = {})
+        : Channels(allocator) {
+    }
 
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
@@ -512,11 +558,17 @@ struct ChannelListUpdated : public Base {
 };
 
 struct ChannelOpened : public Base {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
     uint16_t Id;
-    std::string Name;
+    std::pmr::string Name;
+
+    std::pmr::vector<std::pmr::string> Participants;
+    std::pmr::vector<std::pmr::string> Invitees;
 
-    std::vector<std::string> Participants;
-    std::vector<std::string> Invitees;
+    explicit ChannelOpened(const allocator_type &allocator = {})
+        : Name(allocator), Participants(allocator), Invitees(allocator) {
+    }
 
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
@@ -534,7 +586,13 @@ struct ChannelClosed : public Base {
 };
 
 struct PrivateConversationOpened : public Base {
-    std::string Name;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    std::pmr::string Name;
+
+    explicit PrivateConversationOpened(const allocator_type &allocator = {})
+        : Name(allocator) {
+    }
 
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
@@ -543,13 +601,15 @@ struct PrivateConversationOpened : public Base {
 };
 
 struct ContainerOpened : public Base {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
     uint32_t ContainerId;
 
     uint16_t ItemId;
     uint8_t Mark = 255;
     uint8_t Animation = 0;
 
-    std::string Name;
+    std::pmr::string Name;
     uint8_t SlotsPerPage;
     uint8_t HasParent;
 
@@ -558,7 +618,11 @@ struct ContainerOpened : public Base {
     uint16_t TotalObjects;
     uint16_t StartIndex = 0;
 
-    std::vector<Object> Items;
+    std::pmr::vector<Object> Items;
+
+    explicit ContainerOpened(const allocator_type &allocator = {})
+        : Name(allocator), Items(allocator) {
+    }
 
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
@@ -647,9 +711,15 @@ struct MissileFired : public Base {
 };
 
 struct StatusMessageReceived : public Base {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
     MessageMode Mode;
 
-    std::string Message;
+    std::pmr::string Message;
+
+    explicit StatusMessageReceived(const allocator_type &allocator = {})
+        : Message(allocator) {
+    }
 
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
@@ -660,6 +730,11 @@ struct StatusMessageReceived : public Base {
 struct StatusMessageReceivedInChannel : public StatusMessageReceived {
     uint16_t ChannelId;
 
+    explicit StatusMessageReceivedInChannel(
+            const allocator_type &allocator = {})
+        : StatusMessageReceived(allocator) {
+    }
+
     virtual void Update(Gamestate &gamestate) const;
     virtual Events::Type Kind() const {
         return Events::Type::StatusMessageReceivedInChannel;
@@ -145,7 +145,8 @@ std::pair<std::unique_ptr<Recording>, bool> Read(const DataReader &file,
                            [&](DataReader packetReader, auto timestamp) {
                                recording->Frames.emplace_back(
                                        timestamp,
-                                       parser.Parse(packetReader));
+                                       parser.Parse(packetReader,
+                                                    recording->Storage));
                            });
 
             /* Fragment checksum; usually not even valid. */
@@ -158,7 +158,7 @@ public:
     RecParser(const Version &version, bool repair) : Parser(version, repair) {
     }
 
-    Parser::EventList ParseLogin(DataReader &reader) {
+    Events::Range ParseLogin(DataReader &reader, Parser::EventList &events) {
         while (reader.Remaining() > 0) {
             try {
                 auto peek = reader.Peek<uint32_t>();
@@ -189,23 +189,23 @@ public:
                 /* */
             }
 
-            return Parser::Parse(reader);
+            return Parser::Parse(reader, events);
         }
 
         return {};
     }
 
-    Parser::EventList Parse(DataReader &reader) {
+    Events::Range Parse(DataReader &reader, Parser::EventList &events) {
         const auto backtrack = reader;
 
         try {
-            return Parser::Parse(reader);
+            return Parser::Parse(reader, events);
         } catch ([[maybe_unused]] const InvalidDataError &e) {
             /* This is either a legit parse error or an unexpected login-state
              * packet; try to recover by handling the latter. */
             reader = backtrack;
 
-            return ParseLogin(reader);
+            return ParseLogin(reader, events);
         }
     }
 };
@@ -254,7 +254,8 @@ std::pair<std::unique_ptr<Recording>, bool> Read(const DataReader &file,
                            [&](DataReader packetReader, auto timestamp) {
                                recording->Frames.emplace_back(
                                        timestamp,
-                                       parser.Parse(packetReader));
+                                       parser.Parse(packetReader,
+                                                    recording->Storage));
                            });
 
             if (state.Obfuscation.Checksum) {
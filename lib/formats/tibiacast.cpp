@@ -31,6 +31,7 @@ extern "C" {
 #include "parser.hpp"
 
 #include <utility>
+#include <vector>
 
 namespace trc {
 namespace Recordings {
@@ -47,16 +48,13 @@ enum class RecordingPacketType {
     Last = OutgoingMessage
 };
 
-template <typename T> static T &AddEvent(Parser::EventList &events) {
-    return static_cast<T &>(*events.emplace_back(std::make_unique<T>()));
-}
-
 static void ParseTibiaData(DataReader &reader,
                            Parser &parser,
-                           Parser::EventList &events) {
+                           Parser::EventList &events,
+                           Events::Range &range) {
     for (auto count = reader.ReadU16(); count > 0; count--) {
         if (auto packetReader = reader.Slice(reader.ReadU16())) {
-            events.splice(events.end(), parser.Parse(packetReader));
+            range.Extend(parser.Parse(packetReader, events));
 
             if (packetReader.Remaining() > 0) {
                 throw InvalidDataError();
@@ -65,15 +63,15 @@ static void ParseTibiaData(DataReader &reader,
     }
 }
 
-static Parser::EventList ParseCreatureList(DataReader &reader,
-                                           const Version &version) {
+static std::vector<CreatureSeen> ParseCreatureList(DataReader &reader,
+                                                   const Version &version) {
     /* HAZY: when was this widened to u16? Assume container version 4. */
     uint16_t creatureCount =
             version.AtLeast(9, 54) ? reader.ReadU16() : reader.ReadU8();
-    Parser::EventList creatures;
+    std::vector<CreatureSeen> creatures;
 
     while (creatureCount--) {
-        auto &event = AddEvent<CreatureSeen>(creatures);
+        auto &event = creatures.emplace_back();
 
         event.CreatureId = reader.ReadU32();
 
@@ -132,32 +130,38 @@ static Parser::EventList ParseCreatureList(DataReader &reader,
 static void ParseInitialization(DataReader &reader,
                                 const Version &version,
                                 Parser &parser,
-                                Parser::EventList &events) {
+                                Parser::EventList &events,
+                                Events::Range &range) {
     if (version.Protocol.PreviewByte) {
         reader.SkipU8();
     }
 
-    Parser::EventList creatures = ParseCreatureList(reader, version);
+    auto creatures = ParseCreatureList(reader, version);
 
     auto subpacketCount = reader.ReadU16<1>();
 
     /* The first Tibia data packet clears the creature list we've just parsed;
-     * handle that and then splice the CreatureSeen events after that.*/
+     * handle that and then add the CreatureSeen events after that.*/
     {
         auto packetReader = reader.Slice(reader.ReadU16());
-        events.splice(events.end(), parser.Parse(packetReader));
+        range.Extend(parser.Parse(packetReader, events));
 
-        for (const auto &event : creatures) {
-            auto creatureSeen = static_cast<const CreatureSeen &>(*event);
+        const auto first = events.end();
+
+        for (auto &creatureSeen : creatures) {
             parser.MarkCreatureKnown(creatureSeen.CreatureId);
+
+            /* Assign rather than move-construct, placing the name in the
+             * list's arena rather than wherever `creatures` had it. */
+            events.Emplace<CreatureSeen>() = std::move(creatureSeen);
         }
 
-        events.splice(events.end(), creatures);
+        range.Extend(Events::Range(first, events.end()));
     }
 
     for (int subpacketIdx = 1; subpacketIdx < subpacketCount; subpacketIdx++) {
         auto subpacketReader = reader.Slice(reader.ReadU16());
-        events.splice(events.end(), parser.Parse(subpacketReader));
+        range.Extend(parser.Parse(subpacketReader, events));
 
         if (subpacketReader.Remaining() > 0) {
             throw InvalidDataError();
@@ -198,14 +202,18 @@ static bool ParsePacket(DataReader &reader,
             auto &frame = recording.Frames.emplace_back();
             frame.Timestamp = timestamp;
 
-            ParseInitialization(reader, version, parser, frame.Events);
+            ParseInitialization(reader,
+                                version,
+                                parser,
+                                recording.Storage,
+                                frame.Events);
             break;
         }
         case RecordingPacketType::TibiaData: {
             auto &frame = recording.Frames.emplace_back();
             frame.Timestamp = timestamp;
 
-            ParseTibiaData(reader, parser, frame.Events);
+            ParseTibiaData(reader, parser, recording.Storage, frame.Events);
             break;
         }
         case RecordingPacketType::StateCorrection:
@@ -169,7 +169,8 @@ std::pair<std::unique_ptr<Recording>, bool> Read(
                                [&](DataReader packetReader, auto timestamp) {
                                    recording->Frames.emplace_back(
                                            timestamp,
-                                           parser.Parse(packetReader));
+                                           parser.Parse(packetReader,
+                                                        recording->Storage));
                                });
 
                 frameTime += frameDelay;
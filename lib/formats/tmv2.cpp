@@ -64,7 +64,7 @@ void ReadNextFrame(DataReader &reader, Parser &parser, Recording &recording) {
     frame.Timestamp = std::chrono::milliseconds(timestamp);
 
     while (packetReader.Remaining() > 0) {
-        frame.Events.splice(frame.Events.end(), parser.Parse(packetReader));
+        frame.Events.Extend(parser.Parse(packetReader, recording.Storage));
     }
 }
 
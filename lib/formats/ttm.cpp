@@ -72,7 +72,8 @@ std::pair<std::unique_ptr<Recording>, bool> Read(const DataReader &file,
             auto packetReader = reader.Slice(reader.ReadU16());
 
             recording->Frames.emplace_back(timestamp,
-                                           parser.Parse(packetReader));
+                                           parser.Parse(packetReader,
+                                                        recording->Storage));
 
             if (reader.Remaining() == 0) {
                 break;
@@ -49,7 +49,8 @@ std::pair<std::unique_ptr<Recording>, bool> Read(const DataReader &file,
             auto packetReader = reader.Slice(reader.ReadU16());
 
             recording->Frames.emplace_back(std::chrono::milliseconds(timestamp),
-                                           parser.Parse(packetReader));
+                                           parser.Parse(packetReader,
+                                                        recording->Storage));
         }
 
         if (recording->Frames.empty()) {
@@ -38,8 +38,8 @@ void Gamestate::AddMissileEffect(const trc::Position &origin,
 }
 
 void Gamestate::AddTextMessage(MessageMode type,
-                               const std::string &message,
-                               const std::string &author,
+                               std::string_view message,
+                               std::string_view author,
                                const Position &position) {
     Messages.AddMessage(type, position, author, message, CurrentTick);
 }
@@ -51,6 +51,30 @@ void Gamestate::Reset() {
     Creatures.clear();
     Messages.Clear();
     Map.Clear();
+
+    InterfaceGeneration++;
+}
+
+void Gamestate::Restore(const Gamestate &snapshot) {
+    AbortUnless(&snapshot.Version == &Version);
+
+    Player = snapshot.Player;
+
+    SpeedA = snapshot.SpeedA;
+    SpeedB = snapshot.SpeedB;
+    SpeedC = snapshot.SpeedC;
+
+    Containers = snapshot.Containers;
+    Creatures = snapshot.Creatures;
+    Messages.Assign(snapshot.Messages);
+
+    MissileIndex = snapshot.MissileIndex;
+    MissileList = snapshot.MissileList;
+
+    Map.Assign(snapshot.Map);
+
+    CurrentTick = snapshot.CurrentTick;
+    InterfaceGeneration++;
 }
 
 Gamestate::Gamestate(const trc::Version &version) : Version(version) {
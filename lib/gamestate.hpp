@@ -58,6 +58,11 @@ struct Gamestate {
 
     uint32_t CurrentTick = 0;
 
+    /* Bumped whenever something shown in the sidebar changes: the player's
+     * stats, skills, icons and inventory, the skull of their creature, or
+     * any open container. See Renderer::UpdateInterfaceState. */
+    uint32_t InterfaceGeneration = 0;
+
     Gamestate(const trc::Version &version);
 
     Creature *FindCreature(uint32_t id);
@@ -70,11 +75,17 @@ struct Gamestate {
                           const Position &target,
                           uint8_t missileId);
     void AddTextMessage(MessageMode messageType,
-                        const std::string &message,
-                        const std::string &author = std::string(),
+                        std::string_view message,
+                        std::string_view author = {},
                         const Position &position = Position());
 
     void Reset();
+
+    /* Resets this game state to `snapshot`, a copy of a game state of the
+     * same version made earlier on. Unlike plain assignment this keeps the
+     * map revision and other change counters moving forward, so that
+     * renderer caches notice that everything has changed. */
+    void Restore(const Gamestate &snapshot);
 };
 } // namespace trc
 
@@ -47,13 +47,7 @@ struct Map {
     }
 
     const trc::Tile &Tile(int X, int Y, int Z) const {
-        trc::Assert(X >= 0 && Y >= 0 && Z >= 0);
-
-        X %= TileBufferWidth;
-        Y %= TileBufferHeight;
-        Z %= TileBufferDepth;
-
-        return Tiles[X + (Y + (Z * TileBufferHeight)) * TileBufferWidth];
+        return Tiles[TileIndex(X, Y, Z)];
     }
 
     trc::Tile &Tile(const trc::Position &position) {
@@ -61,13 +55,7 @@ struct Map {
     }
 
     trc::Tile &Tile(int X, int Y, int Z) {
-        Assert(X >= 0 && Y >= 0 && Z >= 0);
-
-        X %= TileBufferWidth;
-        Y %= TileBufferHeight;
-        Z %= TileBufferDepth;
-
-        return Tiles[X + (Y + (Z * TileBufferHeight)) * TileBufferWidth];
+        return Tiles[TileIndex(X, Y, Z)];
     }
 
     uint8_t GetRenderHeight(int rX, int bY) const {
@@ -90,16 +78,117 @@ struct Map {
         }
     }
 
+    /* Which tiles of a floor hold anything, one bit per column of the tile
+     * buffer (`X % TileBufferWidth`) for each of its rows
+     * (`Y % TileBufferHeight`), letting the renderer skip empty tiles and
+     * floors without looking at them. */
+    struct Occupancy {
+        /* Tiles with objects or graphical effects on them. */
+        std::array<uint32_t, TileBufferHeight> Occupied;
+        /* Tiles with creatures on them, a subset of the above. */
+        std::array<uint32_t, TileBufferHeight> Inhabited;
+
+        bool Empty() const {
+            for (uint32_t row : Occupied) {
+                if (row != 0) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    const Occupancy &GetOccupancy(int Z) const {
+        Assert(Z >= 0);
+
+        return Occupancies[Z % TileBufferDepth];
+    }
+
+    /* Updates the occupancy of the given tile after its objects or effects
+     * have changed. */
+    void UpdateOccupancy(const trc::Position &position) {
+        const auto &tile = Tile(position);
+        bool occupied = tile.ObjectCount > 0, inhabited = false;
+
+        for (int objectIdx = 0; objectIdx < tile.ObjectCount; objectIdx++) {
+            inhabited |= tile.Objects[objectIdx].IsCreature();
+        }
+
+        for (const auto &effect : tile.GraphicalEffects) {
+            occupied |= effect.Id != 0;
+        }
+
+        auto &occupancy = Occupancies[position.Z % TileBufferDepth];
+        auto &occupiedRow = occupancy.Occupied[position.Y % TileBufferHeight];
+        auto &inhabitedRow =
+                occupancy.Inhabited[position.Y % TileBufferHeight];
+        const uint32_t bit = 1u << (position.X % TileBufferWidth);
+
+        occupiedRow = occupied ? (occupiedRow | bit) : (occupiedRow & ~bit);
+        inhabitedRow = inhabited ? (inhabitedRow | bit) : (inhabitedRow & ~bit);
+    }
+
+    /* Marks the given tile as changed, letting the renderer know that it has
+     * to be redrawn. Anything that alters the contents of a tile must call
+     * this, save for tick-driven things like effects and animations which
+     * the renderer keeps track of on its own. New effects must call
+     * UpdateOccupancy() instead. */
+    void Touch(const trc::Position &position) {
+        Revisions[TileIndex(position.X, position.Y, position.Z)] = ++Revision;
+        UpdateOccupancy(position);
+    }
+
+    /* Returns the revision of the most recent change to any tile. */
+    uint32_t GetRevision() const {
+        return Revision;
+    }
+
+    /* Returns the revision of the most recent change to the given tile. */
+    uint32_t GetRevision(int X, int Y, int Z) const {
+        return Revisions[TileIndex(X, Y, Z)];
+    }
+
     void Clear() {
         for (auto &tile : Tiles) {
             tile.Clear();
         }
+
+        Revisions.fill(++Revision);
+        Occupancies = {};
+    }
+
+    /* Replaces the contents of this map with those of `other`, marking all
+     * tiles as changed. */
+    void Assign(const trc::Map &other) {
+        const uint32_t revision = Revision;
+
+        *this = other;
+
+        Revision = revision;
+        Revisions.fill(++Revision);
     }
 
 private:
+    static int TileIndex(int X, int Y, int Z) {
+        Assert(X >= 0 && Y >= 0 && Z >= 0);
+
+        X %= TileBufferWidth;
+        Y %= TileBufferHeight;
+        Z %= TileBufferDepth;
+
+        return X + (Y + (Z * TileBufferHeight)) * TileBufferWidth;
+    }
+
     std::array<trc::Tile, TileBufferWidth * TileBufferHeight * TileBufferDepth>
             Tiles;
     std::array<uint8_t, RenderHeightMapSize> RenderHeightMap;
+
+    uint32_t Revision = 0;
+    std::array<uint32_t, TileBufferWidth * TileBufferHeight * TileBufferDepth>
+            Revisions = {};
+
+    std::array<Occupancy, TileBufferDepth> Occupancies = {};
 };
 } // namespace trc
 
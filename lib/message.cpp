@@ -119,7 +119,7 @@ std::strong_ordering MessageList::CompareTypes(MessageMode messageType,
 
 std::strong_ordering MessageList::SortFunction(MessageMode type,
                                                const Position &position,
-                                               const std::string &author,
+                                               std::string_view author,
                                                const Message &compareTo) {
     auto typeCompare = CompareTypes(type, compareTo.Type);
 
@@ -172,8 +172,8 @@ std::pair<bool, bool> MessageList::QueryNext(MessageList::Iterator current) {
 
 void MessageList::AddMessage(MessageMode type,
                              const Position &position,
-                             const std::string &author,
-                             const std::string &text,
+                             std::string_view author,
+                             std::string_view text,
                              uint32_t tick) {
     auto insert_before = std::find_if(begin(), end(), [=](const auto &element) {
         return SortFunction(type, position, author, element) !=
@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <utility>
 #include <string>
+#include <string_view>
 #include <list>
 
 #include "pixel.hpp"
@@ -121,8 +122,8 @@ struct Message {
 
     Message(MessageMode type,
             const trc::Position &position,
-            const std::string &author,
-            const std::string &text,
+            std::string_view author,
+            std::string_view text,
             uint32_t endTick)
         : Type(type),
           Position(position),
@@ -142,12 +143,13 @@ private:
 
 class MessageList {
     std::list<Message> Messages;
+    uint32_t Generation = 0;
 
     static std::strong_ordering CompareTypes(MessageMode messageType,
                                              MessageMode compareType);
     static std::strong_ordering SortFunction(MessageMode type,
                                              const Position &position,
-                                             const std::string &author,
+                                             std::string_view author,
                                              const Message &compareTo);
 
 public:
@@ -158,20 +160,36 @@ public:
 
     void AddMessage(MessageMode type,
                     const trc::Position &position,
-                    const std::string &author,
-                    const std::string &text,
+                    std::string_view author,
+                    std::string_view text,
                     uint32_t tick);
 
     void Prune(uint32_t tick) {
         /* FIXME: This is naive until the C++ migration is complete,
          * performance is not important at the moment. */
-        std::erase_if(Messages, [tick](const auto &message) {
-            return message.EndTick < tick;
-        });
+        if (std::erase_if(Messages, [tick](const auto &message) {
+                return message.EndTick < tick;
+            }) > 0) {
+            Generation++;
+        }
     }
 
     void Clear() {
         Messages.clear();
+        Generation++;
+    }
+
+    /* Replaces the messages with those of `other`, as a new generation. */
+    void Assign(const MessageList &other) {
+        Messages = other.Messages;
+        Generation++;
+    }
+
+    /* Bumped whenever messages are removed by Prune(), Clear(), or Assign(),
+     * letting caches of rendered text drop what's no longer shown, see
+     * TextRenderer::Cache. */
+    uint32_t GetGeneration() const {
+        return Generation;
     }
 
     Iterator begin() const {
@@ -24,6 +24,8 @@
 #include <cstdint>
 
 namespace trc {
+class EntityType;
+
 struct Object {
     static constexpr uint16_t CreatureMarker = 0x63;
 
@@ -40,7 +42,12 @@ struct Object {
 
     uint32_t PhaseTick;
 
-    Object(uint16_t id) : Id(id), PhaseTick(0) {
+    /* The item type of `Id` when the object was parsed, sparing the renderer
+     * a lookup per draw. This is null for creatures and objects that were
+     * made up along the way, see Version::GetItem(const Object &). */
+    const EntityType *Type;
+
+    Object(uint16_t id) : Id(id), PhaseTick(0), Type(nullptr) {
     }
 
     Object() : Object(0) {
@@ -42,7 +42,7 @@ namespace trc {
 using namespace Events;
 
 template <typename T> static T &AddEvent(Parser::EventList &events) {
-    return static_cast<T &>(*events.emplace_back(std::make_unique<T>()));
+    return events.Emplace<T>();
 }
 
 Position Parser::ParsePosition(DataReader &reader) {
@@ -75,8 +75,7 @@ Appearance Parser::ParseAppearance(DataReader &reader) {
         outfit.Item.ExtraByte = 0;
 
         if (outfit.Item.Id != 0) {
-            /* Assertion. */
-            (void)Version_.GetItem(outfit.Item.Id);
+            outfit.Item.Type = &Version_.GetItem(outfit.Item.Id);
         }
     } else {
         /* Assertion. */
@@ -141,7 +140,7 @@ void Parser::ParseCreatureSeen(DataReader &reader,
         event.Type = CreatureType::Monster;
     }
 
-    event.Name = reader.ReadString();
+    event.Name = reader.ReadStringView();
     event.Health = reader.ReadU8();
 
     event.Heading = reader.Read<Creature::Direction>();
@@ -301,6 +300,8 @@ void Parser::ParseCreatureCompact(DataReader &reader,
 void Parser::ParseItem(DataReader &reader, Object &object) {
     const auto &type = Version_.GetItem(object.Id);
 
+    object.Type = &type;
+
     if (Version_.Protocol.ItemMarks) {
         object.Mark = reader.ReadU8();
     } else {
@@ -333,6 +334,7 @@ void Parser::ParseObject(DataReader &reader,
                          EventList &events,
                          Object &object) {
     object.Id = reader.ReadU16();
+    object.Type = nullptr;
 
     switch (object.Id) {
     case 0:
@@ -371,13 +373,20 @@ uint16_t Parser::ParseTileDescription(DataReader &reader,
         }
     }
 
+    /* Objects are gathered on the side before being copied into the event,
+     * as growing the latter one object at a time would leave the discarded
+     * buffers behind in the event arena. */
+    TileObjects_.clear();
+
     while (peekValue < 0xFF00) {
-        auto &object = event.Objects.emplace_back();
+        auto &object = TileObjects_.emplace_back();
         ParseObject(reader, events, object);
 
         peekValue = reader.Peek<uint16_t>();
     }
 
+    event.Objects.assign(TileObjects_.cbegin(), TileObjects_.cend());
+
     peekValue = reader.ReadU16();
     return peekValue & 0xFF;
 }
@@ -630,7 +639,7 @@ void Parser::ParseContainerOpen(DataReader &reader, EventList &events) {
         event.Animation = reader.ReadU8();
     }
 
-    event.Name = reader.ReadString();
+    event.Name = reader.ReadStringView();
     event.SlotsPerPage = reader.ReadU8();
     event.HasParent = reader.ReadU8();
 
@@ -647,6 +656,7 @@ void Parser::ParseContainerOpen(DataReader &reader, EventList &events) {
         event.TotalObjects = itemCount;
     }
 
+    event.Items.reserve(itemCount);
     for (auto idx = 0u; idx < itemCount; idx++) {
         auto &item = event.Items.emplace_back();
         ParseObject(reader, events, item);
@@ -1059,6 +1069,8 @@ void Parser::ParsePlayerDataBasic(DataReader &reader, EventList &events) {
     event.Vocation = reader.ReadU8();
 
     auto spellCount = reader.ReadU16();
+
+    event.Spells.reserve(spellCount);
     while (spellCount--) {
         event.Spells.push_back(reader.ReadU16());
     }
@@ -1217,8 +1229,8 @@ void Parser::ParsePlayerTactics(DataReader &reader, EventList &events) {
 
 static void ValidateTextMessage(
         [[maybe_unused]] MessageMode messageMode,
-        [[maybe_unused]] const std::string &message,
-        [[maybe_unused]] const std::string &author = std::string()) {
+        [[maybe_unused]] std::string_view message,
+        [[maybe_unused]] std::string_view author = {}) {
 #ifndef NDEBUG
     if (author.size() > 0 && author.at(0) == 'a') {
         /* Names that start with a lowercase "a" or "an" are in all likelyhood
@@ -1315,7 +1327,7 @@ void Parser::ParseCreatureSpeak(DataReader &reader, EventList &events) {
         messageId = reader.ReadU32();
     }
 
-    std::string authorName = reader.ReadString();
+    auto authorName = reader.ReadStringView();
 
     uint16_t speakerLevel = 0;
     if (Version_.Protocol.SpeakerLevel) {
@@ -1343,7 +1355,7 @@ void Parser::ParseCreatureSpeak(DataReader &reader, EventList &events) {
          * the Tibia client displays all received messages regardless of
          * coordinates. */
         event.Position = ParsePosition(reader);
-        event.Message = reader.ReadString();
+        event.Message = reader.ReadStringView();
 
         ValidateTextMessage(event.Mode, event.Message, event.AuthorName);
         break;
@@ -1358,7 +1370,7 @@ void Parser::ParseCreatureSpeak(DataReader &reader, EventList &events) {
         event.AuthorLevel = speakerLevel;
 
         /* These message types use the null position. */
-        event.Message = reader.ReadString();
+        event.Message = reader.ReadStringView();
 
         break;
     }
@@ -1369,7 +1381,7 @@ void Parser::ParseCreatureSpeak(DataReader &reader, EventList &events) {
         event.Mode = messageMode;
         event.AuthorName = authorName;
         event.AuthorLevel = speakerLevel;
-        event.Message = reader.ReadString();
+        event.Message = reader.ReadStringView();
 
         break;
     }
@@ -1385,7 +1397,7 @@ void Parser::ParseCreatureSpeak(DataReader &reader, EventList &events) {
         event.AuthorLevel = speakerLevel;
 
         event.ChannelId = reader.ReadU16();
-        event.Message = reader.ReadString();
+        event.Message = reader.ReadStringView();
         break;
     }
     default:
@@ -1398,9 +1410,10 @@ void Parser::ParseChannelList(DataReader &reader, EventList &events) {
 
     auto channelCount = reader.ReadU8();
 
+    event.Channels.reserve(channelCount);
     while (channelCount--) {
         auto id = reader.ReadU16();
-        auto name = reader.ReadString();
+        auto name = reader.ReadStringView();
 
         event.Channels.emplace_back(id, name);
     }
@@ -1410,21 +1423,21 @@ void Parser::ParseChannelOpen(DataReader &reader, EventList &events) {
     auto &event = AddEvent<ChannelOpened>(events);
 
     event.Id = reader.ReadU16();
-    event.Name = reader.ReadString();
+    event.Name = reader.ReadStringView();
 
     if (Version_.Protocol.ChannelParticipants) {
         auto participantCount = reader.ReadU16();
 
         event.Participants.reserve(participantCount);
         while (participantCount--) {
-            event.Participants.push_back(reader.ReadString());
+            event.Participants.emplace_back(reader.ReadStringView());
         }
 
         auto inviteeCount = reader.ReadU16();
 
         event.Invitees.reserve(inviteeCount);
         while (inviteeCount--) {
-            event.Invitees.push_back(reader.ReadString());
+            event.Invitees.emplace_back(reader.ReadStringView());
         }
     }
 }
@@ -1439,7 +1452,7 @@ void Parser::ParseOpenPrivateConversation(DataReader &reader,
                                           EventList &events) {
     auto &event = AddEvent<PrivateConversationOpened>(events);
 
-    event.Name = reader.ReadString();
+    event.Name = reader.ReadStringView();
 }
 
 void Parser::ParseTextMessage(DataReader &reader, EventList &events) {
@@ -1458,7 +1471,7 @@ void Parser::ParseTextMessage(DataReader &reader, EventList &events) {
 
         event.Mode = messageMode;
         event.ChannelId = reader.ReadU16();
-        event.Message = reader.ReadString();
+        event.Message = reader.ReadStringView();
         return;
     }
     case MessageMode::DamageDealt:
@@ -1533,7 +1546,7 @@ void Parser::ParseTextMessage(DataReader &reader, EventList &events) {
     auto &event = AddEvent<StatusMessageReceived>(events);
 
     event.Mode = messageMode;
-    event.Message = reader.ReadString();
+    event.Message = reader.ReadStringView();
 
     ValidateTextMessage(messageMode, event.Message);
 }
@@ -1977,8 +1990,8 @@ void Parser::ParseMoveWest(DataReader &reader, EventList &events) {
     ParseMapDescription(reader, events, -8, -6, 1, Map::TileBufferHeight);
 }
 
-Parser::EventList Parser::Parse(DataReader &reader) {
-    Parser::EventList events;
+Events::Range Parser::Parse(DataReader &reader, Parser::EventList &events) {
+    const auto first = events.end();
     Parser::Repair repair;
 
     /* FIXME: Store significant branches (e.g item stackable or not) in
@@ -1987,11 +2000,16 @@ Parser::EventList Parser::Parse(DataReader &reader) {
      * the branches until we've successfully parsed the entire payload.
      *
      * Needless to say, this is combinatorial. */
-    while (reader.Remaining() > 0) {
-        ParseNext(reader, repair, events);
+    try {
+        while (reader.Remaining() > 0) {
+            ParseNext(reader, repair, events);
+        }
+    } catch (...) {
+        events.Truncate(first);
+        throw;
     }
 
-    return events;
+    return Events::Range(first, events.end());
 }
 
 void Parser::ParseNext(DataReader &reader,
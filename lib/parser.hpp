@@ -22,24 +22,27 @@
 #define __TRC_PARSER_HPP__
 
 #include "datareader.hpp"
+#include "eventlist.hpp"
 #include "events.hpp"
 #include "position.hpp"
 
 #include <unordered_set>
-#include <memory>
-#include <list>
+#include <vector>
 
 namespace trc {
 
 class Parser {
 public:
-    using EventList = std::list<std::unique_ptr<Events::Base>>;
+    using EventList = Events::List;
 
     Parser(const Version &version, bool repair)
         : Version_(version), Repair_(repair) {
     }
 
-    EventList Parse(DataReader &reader);
+    /* Parses a packet, adding its events to the end of `events` and
+     * returning their range. Nothing is added should the packet fail to
+     * parse. */
+    Events::Range Parse(DataReader &reader, EventList &events);
 
     /* Tibiacast recordings start with a set of creature initialization
      * packets outside of the Tibia data stream, so we expose this to mark them
@@ -52,6 +55,7 @@ private:
     const Version &Version_;
 
     std::unordered_set<uint32_t> KnownCreatures_;
+    std::vector<Object> TileObjects_;
     Position Position_;
     [[maybe_unused]] bool Repair_;
 
@@ -38,6 +38,8 @@ struct Position {
         /* Null position according to the protocol, used for inventory and so
          * on. */
     }
+
+    bool operator==(const Position &other) const = default;
 };
 
 } // namespace trc
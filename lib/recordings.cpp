@@ -22,6 +22,9 @@
 #include "versions.hpp"
 
 #include "utils.hpp"
+
+#include <algorithm>
+#include <iterator>
 #include <unordered_map>
 
 namespace trc {
@@ -92,6 +95,103 @@ extern std::pair<std::unique_ptr<Recording>, bool> Read(const DataReader &file,
                                                         Recovery recovery);
 } // namespace YATC
 
+std::vector<Recording::Frame>::const_iterator Recording::FindFrame(
+        std::chrono::milliseconds timestamp) const {
+    return std::ranges::lower_bound(Frames, timestamp, {}, &Frame::Timestamp);
+}
+
+KeyframeIndex::KeyframeIndex(std::chrono::milliseconds interval,
+                             size_t memoryLimit)
+    : BaseInterval(interval), MemoryLimit(memoryLimit), Interval(interval) {
+    AbortUnless(interval.count() > 0);
+}
+
+/* This only needs to be in the right ballpark, so we ignore allocator
+ * overhead and the like. */
+static size_t EstimateSize(const Gamestate &gamestate) {
+    size_t size = sizeof(KeyframeIndex::Keyframe);
+
+    for (const auto &[_, creature] : gamestate.Creatures) {
+        size += sizeof(std::pair<uint32_t, Creature>) + creature.Name.size();
+    }
+
+    for (const auto &[_, container] : gamestate.Containers) {
+        size += sizeof(std::pair<uint32_t, Container>) + container.Name.size() +
+                container.Items.size() * sizeof(Object);
+    }
+
+    for (const auto &message : gamestate.Messages) {
+        size += sizeof(Message) + message.Author.size() + message.Text.size();
+    }
+
+    return size;
+}
+
+bool KeyframeIndex::Record(const Recording &recording,
+                           FrameIterator next,
+                           const Gamestate &gamestate) {
+    if (next == recording.Frames.cbegin()) {
+        return false;
+    }
+
+    const auto timestamp = std::prev(next)->Timestamp;
+
+    if (!Keyframes.empty() &&
+        timestamp < Keyframes.back().Frame->Timestamp + Interval) {
+        return false;
+    }
+
+    /* Don't bother with states that can't be rendered yet. */
+    if (!gamestate.Creatures.contains(gamestate.Player.Id)) {
+        return false;
+    }
+
+    const size_t size = EstimateSize(gamestate);
+
+    Keyframes.emplace_back(
+            std::make_unique<Keyframe>(timestamp, next, gamestate),
+            size);
+    MemoryUsage += size;
+
+    while (MemoryUsage > MemoryLimit && Keyframes.size() > 1) {
+        size_t kept = 0;
+
+        MemoryUsage = 0;
+
+        for (size_t index = 0; index < Keyframes.size(); index += 2) {
+            MemoryUsage += Keyframes[index].Size;
+            Keyframes[kept++] = std::move(Keyframes[index]);
+        }
+
+        Keyframes.resize(kept);
+        Interval *= 2;
+    }
+
+    return true;
+}
+
+const KeyframeIndex::Keyframe *KeyframeIndex::Find(
+        std::chrono::milliseconds timestamp) const {
+    auto it = std::upper_bound(Keyframes.cbegin(),
+                               Keyframes.cend(),
+                               timestamp,
+                               [](auto value, const auto &entry) {
+                                   return value < entry.Frame->Timestamp;
+                               });
+
+    if (it == Keyframes.cbegin()) {
+        return nullptr;
+    }
+
+    return std::prev(it)->Frame.get();
+}
+
+void KeyframeIndex::Clear() {
+    Keyframes.clear();
+    MemoryUsage = 0;
+    Interval = BaseInterval;
+}
+
 Format GuessFormat(const std::filesystem::path &path, const DataReader &file) {
     auto magic = file.Peek<uint32_t>();
 
@@ -141,10 +241,11 @@ bool QueryTibiaVersion(Format format,
     }
 }
 
-std::pair<std::unique_ptr<Recording>, bool> Read(Format format,
-                                                 const DataReader &file,
-                                                 const Version &version,
-                                                 Recovery recovery) {
+static std::pair<std::unique_ptr<Recording>, bool> ReadFormat(
+        Format format,
+        const DataReader &file,
+        const Version &version,
+        Recovery recovery) {
     switch (format) {
     case Format::Cam:
         return Cam::Read(file, version, recovery);
@@ -167,6 +268,25 @@ std::pair<std::unique_ptr<Recording>, bool> Read(Format format,
     }
 }
 
+std::pair<std::unique_ptr<Recording>, bool> Read(Format format,
+                                                 const DataReader &file,
+                                                 const Version &version,
+                                                 Recovery recovery) {
+    auto result = ReadFormat(format, file, version, recovery);
+    auto &frames = result.first->Frames;
+
+    /* Frames are played in the order they're stored regardless of their
+     * timestamps, so a frame that claims to happen before the one preceding
+     * it is shown together with the latter. Make that explicit, keeping
+     * frames sorted for FindFrame. */
+    for (size_t i = 1; i < frames.size(); i++) {
+        frames[i].Timestamp =
+                std::max(frames[i].Timestamp, frames[i - 1].Timestamp);
+    }
+
+    return result;
+}
+
 const FormatNames &FormatNames::Get(Format format) {
     static const FormatNames Unknown{"unknown", "unknown", ".unknown"};
 
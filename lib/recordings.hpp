@@ -25,11 +25,13 @@
 #include "gamestate.hpp"
 
 #include "versions_decl.hpp"
+#include "eventlist.hpp"
 #include "events.hpp"
 
+#include <chrono>
 #include <filesystem>
 #include <memory>
-#include <list>
+#include <vector>
 
 namespace trc {
 namespace Recordings {
@@ -58,11 +60,81 @@ enum class Recovery { None, Repair };
 struct Recording {
     struct Frame {
         std::chrono::milliseconds Timestamp;
-        std::list<std::unique_ptr<Events::Base>> Events;
+        Events::Range Events;
     };
 
     std::chrono::milliseconds Runtime;
-    std::list<Frame> Frames;
+
+    /* Holds the events of all frames, in order. */
+    Events::List Storage;
+
+    /* Sorted by timestamp. */
+    std::vector<Frame> Frames;
+
+    /* Returns the first frame at or after `timestamp`, or the end of `Frames`
+     * if there is none. */
+    std::vector<Frame>::const_iterator FindFrame(
+            std::chrono::milliseconds timestamp) const;
+};
+
+/* Snapshots of the game state taken at regular intervals while a recording
+ * is played from the start, letting players seek backwards by restoring the
+ * nearest earlier snapshot rather than replaying everything before it.
+ *
+ * Keyframes are only taken past the last one, so there's no harm in offering
+ * states that have been seen before. Should they grow beyond the memory limit,
+ * every other keyframe is dropped and the interval doubled, keeping them
+ * evenly spread at the expense of longer seeks. */
+class KeyframeIndex {
+public:
+    using FrameIterator = std::vector<Recording::Frame>::const_iterator;
+
+    struct Keyframe {
+        /* The timestamp of the last frame that has been applied to `State`,
+         * and the first frame that has not. */
+        std::chrono::milliseconds Timestamp;
+        FrameIterator Next;
+
+        Gamestate State;
+    };
+
+    KeyframeIndex(std::chrono::milliseconds interval, size_t memoryLimit);
+
+    /* Offers `gamestate` as a keyframe, where `next` is the first frame of
+     * `recording` that has yet to be applied to it. Returns whether it was
+     * taken, letting callers save their own state alongside it. */
+    bool Record(const Recording &recording,
+                FrameIterator next,
+                const Gamestate &gamestate);
+
+    /* Returns the latest keyframe that has no frames past `timestamp`
+     * applied to it, or nullptr if there is none. */
+    const Keyframe *Find(std::chrono::milliseconds timestamp) const;
+
+    void Clear();
+
+    std::chrono::milliseconds GetInterval() const {
+        return Interval;
+    }
+
+    /* Returns a rough estimate of the memory held by the keyframes. */
+    size_t GetMemoryUsage() const {
+        return MemoryUsage;
+    }
+
+private:
+    const std::chrono::milliseconds BaseInterval;
+    const size_t MemoryLimit;
+
+    std::chrono::milliseconds Interval;
+    size_t MemoryUsage = 0;
+
+    struct Entry {
+        std::unique_ptr<Keyframe> Frame;
+        size_t Size;
+    };
+
+    std::vector<Entry> Keyframes;
 };
 
 Format GuessFormat(const std::filesystem::path &path, const DataReader &file);
@@ -23,6 +23,7 @@
 
 #include "canvas.hpp"
 #include "creature.hpp"
+#include "displaylist.hpp"
 #include "effect.hpp"
 #include "fonts.hpp"
 #include "icons.hpp"
@@ -31,11 +32,17 @@
 #include "textrenderer.hpp"
 #include "types.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
 #include <cstdlib>
 #include <format>
 #include <initializer_list>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "utils.hpp"
 
@@ -45,6 +52,127 @@ namespace trc {
 
 namespace Renderer {
 
+static constexpr bool HasSameFlags(Options lhs, const Options &rhs) {
+    lhs.Width = rhs.Width;
+    lhs.Height = rhs.Height;
+    lhs.TintCacheSize = rhs.TintCacheSize;
+
+    return lhs == rhs;
+}
+
+static constexpr Options GetPresetFlags(Preset preset) {
+    Options flags{};
+
+    switch (preset) {
+    case Preset::Custom:
+    case Preset::Default:
+        break;
+    case Preset::Minimap:
+        flags.SkipRenderingCreatures = true;
+        flags.SkipRenderingGraphicalEffects = true;
+        flags.SkipRenderingMissiles = true;
+        flags.SkipRenderingUpperFloors = true;
+        [[fallthrough]];
+    case Preset::MapOnly:
+        flags.SkipRenderingCreatureHealthBars = true;
+        flags.SkipRenderingCreatureIcons = true;
+        flags.SkipRenderingStatusBars = true;
+        flags.SkipRenderingInventory = true;
+        flags.SkipRenderingIconBar = true;
+        [[fallthrough]];
+    case Preset::NoText:
+        flags.SkipRenderingNumericalEffects = true;
+        flags.SkipRenderingNonPlayerNames = true;
+        flags.SkipRenderingPlayerNames = true;
+        flags.SkipRenderingMessages = true;
+        break;
+    }
+
+    return flags;
+}
+
+Preset GetPreset(const Options &options) noexcept {
+    for (auto preset : {Preset::Default,
+                        Preset::MapOnly,
+                        Preset::NoText,
+                        Preset::Minimap}) {
+        if (HasSameFlags(GetPresetFlags(preset), options)) {
+            return preset;
+        }
+    }
+
+    return Preset::Custom;
+}
+
+void ApplyPreset(Preset preset, Options &options) noexcept {
+    Options flags = GetPresetFlags(preset);
+
+    flags.Width = options.Width;
+    flags.Height = options.Height;
+    flags.TintCacheSize = options.TintCacheSize;
+
+    options = flags;
+}
+
+/* Options whose flags are fixed at compile time, hiding those of the base so
+ * that drawing functions templated on their options can leave out the tests
+ * of them altogether. The resolution and tint cache size are still taken
+ * from the base. */
+template <Options Flags>
+struct FixedOptions : public Options {
+    static constexpr bool SkipRenderingCreatures = Flags.SkipRenderingCreatures;
+    static constexpr bool SkipRenderingItems = Flags.SkipRenderingItems;
+
+    static constexpr bool SkipRenderingGraphicalEffects =
+            Flags.SkipRenderingGraphicalEffects;
+    static constexpr bool SkipRenderingNumericalEffects =
+            Flags.SkipRenderingNumericalEffects;
+    static constexpr bool SkipRenderingMissiles = Flags.SkipRenderingMissiles;
+
+    static constexpr bool SkipRenderingCreatureHealthBars =
+            Flags.SkipRenderingCreatureHealthBars;
+    static constexpr bool SkipRenderingCreatureIcons =
+            Flags.SkipRenderingCreatureIcons;
+    static constexpr bool SkipRenderingNonPlayerNames =
+            Flags.SkipRenderingNonPlayerNames;
+    static constexpr bool SkipRenderingPlayerNames =
+            Flags.SkipRenderingPlayerNames;
+
+    static constexpr bool SkipRenderingYellingMessages =
+            Flags.SkipRenderingYellingMessages;
+    static constexpr bool SkipRenderingMessages = Flags.SkipRenderingMessages;
+
+    static constexpr bool SkipRenderingUpperFloors =
+            Flags.SkipRenderingUpperFloors;
+    static constexpr bool SkipRenderingStatusBars =
+            Flags.SkipRenderingStatusBars;
+
+    static constexpr bool SkipRenderingPrivateMessages =
+            Flags.SkipRenderingPrivateMessages;
+    static constexpr bool SkipRenderingHotkeyMessages =
+            Flags.SkipRenderingHotkeyMessages;
+    static constexpr bool SkipRenderingStatusMessages =
+            Flags.SkipRenderingStatusMessages;
+    static constexpr bool SkipRenderingSpellMessages =
+            Flags.SkipRenderingSpellMessages;
+    static constexpr bool SkipRenderingLootMessages =
+            Flags.SkipRenderingLootMessages;
+
+    static constexpr bool SkipRenderingInventory = Flags.SkipRenderingInventory;
+    static constexpr bool SkipRenderingIconBar = Flags.SkipRenderingIconBar;
+
+    FixedOptions(const Options &options) : Options(options) {
+        Assert(HasSameFlags(Flags, options));
+    }
+};
+
+/* The options that drawing functions are instantiated with for `P`, where
+ * custom options are tested at run-time as usual. */
+template <Preset P>
+using PresetOptions = std::conditional_t<P == Preset::Custom,
+                                         Options,
+                                         FixedOptions<GetPresetFlags(P)>>;
+
 static Pixel Convert8BitColor(uint8_t color) {
     return Pixel(((color / 36) * 51),
                  (((color / 6) % 6) * 51),
@@ -99,59 +227,6 @@ static Pixel GetCreatureInfoColor(int healthPercentage, int isObscured) {
     return Pixel(0, 192, 0);
 }
 
-static bool GetTileUnlookable(const Version &version, const Tile &tile) {
-    for (int objectIdx = 0; objectIdx < tile.ObjectCount; objectIdx++) {
-        const auto &object = tile.Objects[objectIdx];
-
-        if (!object.IsCreature()) {
-            const auto &properties = version.GetItem(object.Id).Properties;
-
-            if (properties.Unlookable) {
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
-static bool GetTileUpdateRenderHeight(const Version &version,
-                                      const Tile &tile) {
-    for (int objectIdx = 0; objectIdx < tile.ObjectCount; objectIdx++) {
-        const auto &object = tile.Objects[objectIdx];
-
-        if (!object.IsCreature()) {
-            const auto &properties = version.GetItem(object.Id).Properties;
-
-            if (!properties.DontHide && properties.StackPriority == 0) {
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
-static bool GetTileBlocksPlayerVision(const Version &version,
-                                      const Tile &tile) {
-    for (int objectIdx = 0; objectIdx < tile.ObjectCount; objectIdx++) {
-        const auto &object = tile.Objects[objectIdx];
-
-        if (!object.IsCreature()) {
-            const auto &properties = version.GetItem(object.Id).Properties;
-
-            /* Things with a stack priority of 0 (ground) and 2 (some railings)
-             * count as solids and cannot be seen through. */
-            if (!properties.DontHide && (properties.StackPriority == 0 ||
-                                         properties.StackPriority == 2)) {
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
 static int GetTopVisibleFloor(const Gamestate &gamestate) {
     int minZ = 0;
 
@@ -161,30 +236,24 @@ static int GetTopVisibleFloor(const Gamestate &gamestate) {
         for (int yIdx = gamestate.Map.Position.Y - 1;
              yIdx <= gamestate.Map.Position.Y + 1;
              yIdx++) {
-            if (!GetTileUnlookable(
-                        gamestate.Version,
-                        gamestate.Map.Tile(xIdx,
-                                           yIdx,
-                                           gamestate.Map.Position.Z)) &&
+            if (!gamestate.Map
+                         .Tile(xIdx, yIdx, gamestate.Map.Position.Z)
+                         .Unlookable &&
                 !(xIdx != gamestate.Map.Position.X &&
                   yIdx != gamestate.Map.Position.Y)) {
                 for (int zIdx = gamestate.Map.Position.Z - 1; zIdx >= minZ;
                      zIdx--) {
-                    if (GetTileBlocksPlayerVision(
-                                gamestate.Version,
-                                gamestate.Map.Tile(
-                                        xIdx + (gamestate.Map.Position.Z -
-                                                zIdx),
-                                        yIdx + (gamestate.Map.Position.Z -
-                                                zIdx),
-                                        zIdx))) {
+                    if (gamestate.Map
+                                .Tile(xIdx + (gamestate.Map.Position.Z - zIdx),
+                                      yIdx + (gamestate.Map.Position.Z - zIdx),
+                                      zIdx)
+                                .BlocksPlayerVision) {
                         minZ = zIdx + 1;
                         break;
                     }
 
-                    if (GetTileBlocksPlayerVision(
-                                gamestate.Version,
-                                gamestate.Map.Tile(xIdx, yIdx, zIdx))) {
+                    if (gamestate.Map.Tile(xIdx, yIdx, zIdx)
+                                .BlocksPlayerVision) {
                         minZ = zIdx + 1;
                         break;
                     }
@@ -196,6 +265,7 @@ static int GetTopVisibleFloor(const Gamestate &gamestate) {
     return minZ;
 }
 
+template <typename Target>
 static void DrawTypeBounded(const EntityType::FrameGroup &frameGroup,
                             int rightX,
                             int bottomY,
@@ -206,7 +276,7 @@ static void DrawTypeBounded(const EntityType::FrameGroup &frameGroup,
                             int frame,
                             int maxWidth,
                             int maxHeight,
-                            Canvas &canvas) {
+                            Target &canvas) {
     const auto &sprites = frameGroup.Sprites;
     int heightLeft, widthLeft;
     unsigned spriteIndex;
@@ -247,6 +317,7 @@ static void DrawTypeBounded(const EntityType::FrameGroup &frameGroup,
     }
 }
 
+template <typename Target>
 static void DrawType(const EntityType::FrameGroup &frameGroup,
                      int rightX,
                      int bottomY,
@@ -255,7 +326,7 @@ static void DrawType(const EntityType::FrameGroup &frameGroup,
                      int yMod,
                      int zMod,
                      int frame,
-                     Canvas &canvas) {
+                     Target &canvas) {
     const auto &sprites = frameGroup.Sprites;
     unsigned spriteIndex;
 
@@ -282,6 +353,7 @@ static void DrawType(const EntityType::FrameGroup &frameGroup,
     }
 }
 
+template <typename Target>
 static void TintType(const EntityType::FrameGroup &frameGroup,
                      int head,
                      int primary,
@@ -294,7 +366,7 @@ static void TintType(const EntityType::FrameGroup &frameGroup,
                      int yMod,
                      int zMod,
                      int frame,
-                     Canvas &canvas) {
+                     Target &canvas) {
     const auto &sprites = frameGroup.Sprites;
     unsigned spriteIndex;
 
@@ -325,13 +397,109 @@ static void TintType(const EntityType::FrameGroup &frameGroup,
     }
 }
 
+/* Draws layer 0 of the given type tinted by layer 1, going through the tinted
+ * outfit cache when possible. */
+template <typename Target>
+static void DrawTintedType(const Version &version,
+                           const EntityType::FrameGroup &frameGroup,
+                           int head,
+                           int primary,
+                           int secondary,
+                           int detail,
+                           int rightX,
+                           int bottomY,
+                           int xMod,
+                           int yMod,
+                           int zMod,
+                           int frame,
+                           Target &canvas) {
+    const auto &sprites = frameGroup.Sprites;
+    const unsigned spriteCount = frameGroup.SizeX * frameGroup.SizeY;
+    unsigned baseIndex, tintIndex;
+
+    baseIndex = (xMod + (yMod + (zMod + frame * frameGroup.ZDiv) *
+                                        frameGroup.YDiv) *
+                                frameGroup.XDiv) *
+                frameGroup.LayerCount;
+    baseIndex *= spriteCount;
+    tintIndex = baseIndex + spriteCount;
+
+    if ((tintIndex + spriteCount) > sprites.size()) {
+        /* Incomplete sprite sets are rare enough that we'll leave them to the
+         * uncached path. */
+        DrawType(frameGroup,
+                 rightX,
+                 bottomY,
+                 0,
+                 xMod,
+                 yMod,
+                 zMod,
+                 frame,
+                 canvas);
+        TintType(frameGroup,
+                 head,
+                 primary,
+                 secondary,
+                 detail,
+                 rightX,
+                 bottomY,
+                 1,
+                 xMod,
+                 yMod,
+                 zMod,
+                 frame,
+                 canvas);
+        return;
+    }
+
+    /* As the sprites of a type never overlap, drawing and tinting them one by
+     * one is equivalent to drawing all of them before tinting. */
+    for (int yIdx = 0; yIdx < frameGroup.SizeY; yIdx++) {
+        for (int xIdx = 0; xIdx < frameGroup.SizeX; xIdx++) {
+            const Sprite &base = *sprites[baseIndex++];
+            const Sprite &mask = *sprites[tintIndex++];
+            const int x = rightX - xIdx * 32 - 32;
+            const int y = bottomY - yIdx * 32 - 32;
+
+            auto entry = version.TintedOutfits.Get(base,
+                                                   mask,
+                                                   head,
+                                                   primary,
+                                                   secondary,
+                                                   detail);
+
+            if (entry && entry->Tinted) {
+                /* The entry may be evicted before a display list gets
+                 * around to drawing it. */
+                if constexpr (std::is_same_v<Target, DisplayList>) {
+                    canvas.Retain(entry);
+                }
+
+                canvas.Draw(*entry->Tinted, x, y, 32, 32);
+            } else {
+                canvas.Draw(base, x, y, 32, 32);
+                canvas.Tint(mask,
+                            x,
+                            y,
+                            32,
+                            32,
+                            head,
+                            primary,
+                            secondary,
+                            detail);
+            }
+        }
+    }
+}
+
+template <typename Target>
 static void DrawGraphicalEffect(const Version &version,
                                 const GraphicalEffect &effect,
                                 const Position &position,
                                 int rightX,
                                 int bottomY,
                                 uint32_t tick,
-                                Canvas &canvas) {
+                                Target &canvas) {
     const auto &type = version.GetEffect(effect.Id);
     const auto &frameGroup =
             type.FrameGroups[std::to_underlying(FrameGroupIndex::Default)];
@@ -354,11 +522,12 @@ static void DrawGraphicalEffect(const Version &version,
     }
 }
 
+template <typename Target>
 static void DrawMissile(const Missile &missile,
                         const EntityType &type,
                         int rightX,
                         int bottomY,
-                        Canvas &canvas) {
+                        Target &canvas) {
     float directionalRatio;
     float deltaX, deltaY;
     int direction;
@@ -395,13 +564,15 @@ static void DrawMissile(const Missile &missile,
     }
 }
 
-static bool DrawOutfit(const Creature &creature,
+template <typename Target>
+static bool DrawOutfit(const Version &version,
+                       const Creature &creature,
                        const EntityType &type,
                        int isMounted,
                        int rightX,
                        int bottomY,
                        uint32_t tick,
-                       Canvas &canvas) {
+                       Target &canvas) {
     int directionMod, frame = 0;
     FrameGroupIndex groupId;
 
@@ -461,25 +632,25 @@ static bool DrawOutfit(const Creature &creature,
     for (int addonIdx = 0; addonIdx < frameGroup.YDiv; addonIdx++) {
         if ((addonIdx == 0) ||
             (creature.Outfit.Addons & (1 << (addonIdx - 1)))) {
-            DrawType(frameGroup,
-                     rightX,
-                     bottomY,
-                     0,
-                     directionMod,
-                     addonIdx,
-                     isMounted,
-                     isMounted ? (frame % 3) : frame,
-                     canvas);
-
             if (frameGroup.LayerCount == 2) {
-                TintType(frameGroup,
-                         creature.Outfit.HeadColor,
-                         creature.Outfit.PrimaryColor,
-                         creature.Outfit.SecondaryColor,
-                         creature.Outfit.DetailColor,
+                DrawTintedType(version,
+                               frameGroup,
+                               creature.Outfit.HeadColor,
+                               creature.Outfit.PrimaryColor,
+                               creature.Outfit.SecondaryColor,
+                               creature.Outfit.DetailColor,
+                               rightX,
+                               bottomY,
+                               directionMod,
+                               addonIdx,
+                               isMounted,
+                               isMounted ? (frame % 3) : frame,
+                               canvas);
+            } else {
+                DrawType(frameGroup,
                          rightX,
                          bottomY,
-                         1,
+                         0,
                          directionMod,
                          addonIdx,
                          isMounted,
@@ -493,6 +664,7 @@ static bool DrawOutfit(const Creature &creature,
 }
 
 /* FIXME: Phase ticks should NOT modify the item! */
+template <typename Target>
 static void DrawItem(const Version &version,
                      Object &item,
                      const EntityType &type,
@@ -503,7 +675,7 @@ static void DrawItem(const Version &version,
                      int horizontal,
                      int vertical,
                      int isInInventory,
-                     Canvas &canvas) {
+                     Target &canvas) {
     int frame, xMod, yMod, zMod;
 
     const auto &frameGroup =
@@ -612,12 +784,13 @@ static void DrawItem(const Version &version,
     }
 }
 
+template <typename Target>
 static void DrawCreature(const Version &version,
                          const Creature &creature,
                          int rightX,
                          int bottomY,
                          uint32_t tick,
-                         Canvas &canvas) {
+                         Target &canvas) {
     if (creature.Outfit.Id == 0) {
         if (creature.Outfit.Item.Id != 0) {
             /* Render item */
@@ -633,7 +806,7 @@ static void DrawCreature(const Version &version,
 
             DrawItem(version,
                      item,
-                     version.GetItem(item.Id),
+                     version.GetItem(creature.Outfit.Item),
                      rightX,
                      bottomY,
                      tick,
@@ -668,24 +841,46 @@ static void DrawCreature(const Version &version,
         const auto &outfit = version.GetOutfit(creature.Outfit.Id);
 
         if (creature.Outfit.MountId == 0) {
-            DrawOutfit(creature, outfit, 0, rightX, bottomY, tick, canvas);
+            DrawOutfit(version,
+                       creature,
+                       outfit,
+                       0,
+                       rightX,
+                       bottomY,
+                       tick,
+                       canvas);
         } else {
             const auto &mount = version.GetOutfit(creature.Outfit.MountId);
 
-            DrawOutfit(creature, mount, 0, rightX, bottomY, tick, canvas);
-
-            DrawOutfit(creature, outfit, 1, rightX, bottomY, tick, canvas);
+            DrawOutfit(version,
+                       creature,
+                       mount,
+                       0,
+                       rightX,
+                       bottomY,
+                       tick,
+                       canvas);
+
+            DrawOutfit(version,
+                       creature,
+                       outfit,
+                       1,
+                       rightX,
+                       bottomY,
+                       tick,
+                       canvas);
         }
     }
 }
 
+template <typename Target>
 static void DrawMovingCreatures(Gamestate &gamestate,
                                 const Position &position,
                                 int heightDisplacement,
                                 int rightX,
                                 int bottomY,
                                 uint32_t tick,
-                                Canvas &canvas) {
+                                Target &canvas) {
     /* Check for and draw creatures which might overlap with this tile. */
     for (int yIdx = -1; yIdx <= 1; yIdx++) {
         for (int xIdx = -1; xIdx <= 1; xIdx++) {
@@ -741,13 +936,14 @@ static void DrawMovingCreatures(Gamestate &gamestate,
 }
 
 /* Check for and draw all projectiles which might overlap with this tile. */
+template <typename Target>
 static void DrawMissiles(Gamestate &gamestate,
                          const Position &position,
                          int heightDisplacement,
                          int rightX,
                          int bottomY,
                          uint32_t tick,
-                         Canvas &canvas) {
+                         Target &canvas) {
     const Version &version = gamestate.Version;
     unsigned missileIdx = gamestate.MissileIndex;
 
@@ -791,14 +987,15 @@ static void DrawMissiles(Gamestate &gamestate,
     } while (missileIdx != gamestate.MissileIndex);
 }
 
-static void DrawTile(const Options &options,
+template <typename Settings, typename Target>
+static void DrawTile(const Settings &options,
                      Gamestate &gamestate,
                      const Position &position,
                      int viewOffsetX,
                      int viewOffsetY,
                      uint32_t tick,
                      bool *redrawNearbyTop,
-                     Canvas &canvas) {
+                     Target &canvas) {
     const Version &version = gamestate.Version;
 
     int heightDisplacement, horizontal, vertical, rightX, bottomY;
@@ -812,11 +1009,6 @@ static void DrawTile(const Options &options,
 
     auto &tile = gamestate.Map.Tile(position);
 
-    if (tile.ObjectCount > 0 &&
-        GetTileUpdateRenderHeight(gamestate.Version, tile)) {
-        gamestate.Map.UpdateRenderHeight(rightX, bottomY, position.Z);
-    }
-
     if (*redrawNearbyTop) {
         /* We're only supposed to redraw the top items, so just calculate the
          * proper height displacement and then get on with it. */
@@ -826,7 +1018,7 @@ static void DrawTile(const Options &options,
                 continue;
             } else {
                 const auto &item = tile.Objects[objectIdx];
-                const auto &type = version.GetItem(item.Id);
+                const auto &type = version.GetItem(item);
 
                 if (type.Properties.StackPriority != 3) {
                     heightDisplacement = std::min(
@@ -847,7 +1039,7 @@ static void DrawTile(const Options &options,
                                 !tile.Objects[objectIdx].IsCreature();
              objectIdx++) {
             auto &item = tile.Objects[objectIdx];
-            const auto &type = version.GetItem(item.Id);
+            const auto &type = version.GetItem(item);
 
             if (type.Properties.StackPriority > 2) {
                 break;
@@ -884,7 +1076,7 @@ static void DrawTile(const Options &options,
                  objectIdx >= 0 && !tile.Objects[objectIdx].IsCreature();
                  objectIdx--) {
                 auto &item = tile.Objects[objectIdx];
-                const auto &type = version.GetItem(item.Id);
+                const auto &type = version.GetItem(item);
 
                 if (type.Properties.StackPriority != 5) {
                     break;
@@ -987,7 +1179,7 @@ static void DrawTile(const Options &options,
                                 !tile.Objects[objectIdx].IsCreature();
              objectIdx++) {
             auto &item = tile.Objects[objectIdx];
-            const auto &type = version.GetItem(item.Id);
+            const auto &type = version.GetItem(item);
 
             if (type.Properties.StackPriority > 3) {
                 break;
@@ -1022,7 +1214,7 @@ static void DrawInventoryItem(Gamestate &gamestate,
     canvas.Draw(sprite, X, Y, sprite.Width, sprite.Height);
 
     if (item.Id != 0) {
-        const auto &type = version.GetItem(item.Id);
+        const auto &type = version.GetItem(item);
 
         DrawItem(gamestate.Version,
                  item,
@@ -1067,14 +1259,26 @@ static void DrawInventorySlot(Gamestate &gamestate,
     }
 }
 
-void DrawGamestate(const Options &options,
-                   Gamestate &gamestate,
-                   Canvas &canvas) noexcept {
-    int bottomVisibleFloor, topVisibleFloor;
-    int viewOffsetX, viewOffsetY;
+/* The placement of the game view for the current frame. */
+struct View {
+    int OffsetX;
+    int OffsetY;
+    int TopFloor;
+    int BottomFloor;
+
+    /* Tiles hidden beneath the floors above them, one bit per column for
+     * each row of the view, indexed by floor modulo Map::TileBufferDepth.
+     * See FindHiddenTiles. */
+    std::array<std::array<uint32_t, 14>, Map::TileBufferDepth> Hidden = {};
+};
+
+static View PrepareView(const Options &options, Gamestate &gamestate) {
+    View view;
 
     auto &playerCreature = gamestate.GetCreature(gamestate.Player.Id);
 
+    gamestate.Version.TintedOutfits.Grow(options.TintCacheSize);
+
     /* Force a small amount of light around the player like the Tibia client
      * does. */
     playerCreature.LightIntensity =
@@ -1082,29 +1286,424 @@ void DrawGamestate(const Options &options,
 
     UpdateWalkOffset(gamestate, playerCreature);
 
-    viewOffsetX = (8 - gamestate.Map.Position.X) * 32 -
-                  playerCreature.MovementInformation.WalkOffsetX;
-    viewOffsetY = (6 - gamestate.Map.Position.Y) * 32 -
-                  playerCreature.MovementInformation.WalkOffsetY;
+    view.OffsetX = (8 - gamestate.Map.Position.X) * 32 -
+                   playerCreature.MovementInformation.WalkOffsetX;
+    view.OffsetY = (6 - gamestate.Map.Position.Y) * 32 -
+                   playerCreature.MovementInformation.WalkOffsetY;
 
     if (gamestate.Map.Position.Z > 7) {
-        bottomVisibleFloor = std::min<int>(15, gamestate.Map.Position.Z + 2);
-        topVisibleFloor = gamestate.Map.Position.Z;
+        view.BottomFloor = std::min<int>(15, gamestate.Map.Position.Z + 2);
+        view.TopFloor = gamestate.Map.Position.Z;
     } else {
         if (!options.SkipRenderingUpperFloors) {
-            topVisibleFloor = GetTopVisibleFloor(gamestate);
+            view.TopFloor = GetTopVisibleFloor(gamestate);
         } else {
-            topVisibleFloor = gamestate.Map.Position.Z;
+            view.TopFloor = gamestate.Map.Position.Z;
         }
 
-        bottomVisibleFloor = 7;
+        view.BottomFloor = 7;
     }
 
-    for (int zIdx = bottomVisibleFloor; zIdx >= topVisibleFloor; zIdx--) {
+    return view;
+}
+
+static void UpdateRenderHeights(Gamestate &gamestate, const View &view) {
+    for (int zIdx = view.BottomFloor; zIdx >= view.TopFloor; zIdx--) {
         int xyOffset = gamestate.Map.Position.Z - zIdx;
 
+        if (gamestate.Map.GetOccupancy(zIdx).Empty()) {
+            continue;
+        }
+
         for (int xIdx = 0; xIdx <= 17; xIdx++) {
             for (int yIdx = 0; yIdx <= 13; yIdx++) {
+                Position position(gamestate.Map.Position.X - 8 + xIdx +
+                                          xyOffset,
+                                  gamestate.Map.Position.Y - 6 + yIdx +
+                                          xyOffset,
+                                  zIdx);
+                const auto &tile = gamestate.Map.Tile(position);
+
+                if (tile.UpdatesRenderHeight) {
+                    gamestate.Map.UpdateRenderHeight(
+                            position.X * 32 + view.OffsetX - xyOffset * 32,
+                            position.Y * 32 + view.OffsetY - xyOffset * 32,
+                            position.Z);
+                }
+            }
+        }
+    }
+}
+
+/* Returns whether the first item on `tile` covers the tile with opaque pixels
+ * throughout its animation, hiding whatever the floors below draw there. This
+ * mirrors how DrawTile and DrawItem draw it. */
+static bool IsOpaqueGround(const Version &version,
+                           const Tile &tile,
+                           const Position &position) {
+    if (tile.ObjectCount == 0 || tile.Objects[0].IsCreature()) {
+        return false;
+    }
+
+    const auto &type = version.GetItem(tile.Objects[0]);
+    const auto &properties = type.Properties;
+
+    /* Items whose pictures depend on their state rather than their position
+     * are rarely found at the bottom of a tile, so we don't bother with
+     * them. */
+    if (properties.StackPriority > 2 || properties.DisplacementX != 0 ||
+        properties.DisplacementY != 0 || properties.Hangable ||
+        properties.LiquidContainer || properties.LiquidPool ||
+        properties.Stackable) {
+        return false;
+    }
+
+    const auto &frameGroup =
+            type.FrameGroups[std::to_underlying(FrameGroupIndex::Default)];
+    const auto &sprites = frameGroup.Sprites;
+
+    const int xMod = position.X % frameGroup.XDiv;
+    const int yMod = position.Y % frameGroup.YDiv;
+    const int zMod = position.Z % frameGroup.ZDiv;
+
+    if (frameGroup.FrameCount == 0) {
+        return false;
+    }
+
+    /* Only the first sprite of the first layer covers the tile itself. */
+    for (int frame = 0; frame < frameGroup.FrameCount; frame++) {
+        const unsigned spriteIndex =
+                (xMod + (yMod + (zMod + frame * frameGroup.ZDiv) *
+                                        frameGroup.YDiv) *
+                                frameGroup.XDiv) *
+                frameGroup.LayerCount * frameGroup.SizeX * frameGroup.SizeY;
+
+        if (spriteIndex >= sprites.size() ||
+            sprites[spriteIndex]->GetCoverage() != Sprite::Coverage::Opaque) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Finds the tiles that can't be seen through the opaque ground of the floors
+ * above them, assuming that no tile draws further than `reach` pixels up and
+ * to the left of its bottom-right corner, nor further than GetTileSpill to
+ * the right.
+ *
+ * Only the floors between `view.TopFloor` and `view.BottomFloor` are taken
+ * into account, so the floors that the player can't see through
+ * (GetTopVisibleFloor) never hide anything. */
+static void FindHiddenTiles(const Gamestate &gamestate, int reach, View &view) {
+    /* The cells covered by the floors drawn so far, top to bottom, one bit per
+     * column. As floors are offset by whole tiles, the columns and rows of the
+     * view line up across floors. */
+    std::array<uint32_t, 14> covered = {};
+
+    /* How many cells up and to the left a tile may draw into, including the
+     * tops of the neighbors it redraws, as in DrawFloors. */
+    const int extent = (reach + 31) / 32;
+
+    for (int zIdx = view.TopFloor; zIdx <= view.BottomFloor; zIdx++) {
+        const int xyOffset = gamestate.Map.Position.Z - zIdx;
+        auto &hidden = view.Hidden[zIdx % Map::TileBufferDepth];
+        std::array<uint32_t, 14> spans;
+
+        /* Cells to the left of and above the view are off-screen, and thus
+         * as good as covered. */
+        for (int yIdx = 0; yIdx <= 13; yIdx++) {
+            spans[yIdx] = 0;
+
+            for (int xIdx = 0; xIdx <= 17; xIdx++) {
+                const int leftX = std::max(xIdx - extent, 0);
+                const int rightX = xIdx + (xIdx == 0 ? 1 : 0);
+                const uint32_t mask = ((1u << (rightX - leftX + 1)) - 1)
+                                      << leftX;
+
+                if ((covered[yIdx] & mask) == mask) {
+                    spans[yIdx] |= 1u << xIdx;
+                }
+            }
+        }
+
+        for (int yIdx = 0; yIdx <= 13; yIdx++) {
+            hidden[yIdx] = spans[yIdx];
+
+            for (int rowIdx = std::max(yIdx - extent, 0); rowIdx < yIdx;
+                 rowIdx++) {
+                hidden[yIdx] &= spans[rowIdx];
+            }
+        }
+
+        if (gamestate.Map.GetOccupancy(zIdx).Empty()) {
+            continue;
+        }
+
+        for (int xIdx = 0; xIdx <= 17; xIdx++) {
+            for (int yIdx = 0; yIdx <= 13; yIdx++) {
+                Position position(gamestate.Map.Position.X - 8 + xIdx +
+                                          xyOffset,
+                                  gamestate.Map.Position.Y - 6 + yIdx +
+                                          xyOffset,
+                                  zIdx);
+
+                if (IsOpaqueGround(gamestate.Version,
+                                   gamestate.Map.Tile(position),
+                                   position)) {
+                    covered[yIdx] |= 1u << xIdx;
+                }
+            }
+        }
+    }
+}
+
+/* 32x32 cells of the game view that need to be redrawn. */
+struct DirtyCells {
+    const int Columns;
+    const int Rows;
+    std::vector<bool> Cells;
+
+    /* Number of marked cells above and to the left of each cell, built by
+     * Summarize() to speed up Intersects(). */
+    std::vector<uint16_t> Sums;
+
+    template <typename Target>
+    DirtyCells(const Target &canvas)
+        : Columns((canvas.Width + 31) / 32),
+          Rows((canvas.Height + 31) / 32),
+          Cells(Columns * Rows) {
+    }
+
+    /* Marks the cells covering the given rectangle, right and bottom edges
+     * exclusive. */
+    void Mark(int leftX, int topY, int rightX, int bottomY) {
+        if (rightX <= 0 || bottomY <= 0) {
+            return;
+        }
+
+        const int firstColumn = std::max(leftX, 0) / 32;
+        const int firstRow = std::max(topY, 0) / 32;
+        const int lastColumn = std::min((rightX - 1) / 32, Columns - 1);
+        const int lastRow = std::min((bottomY - 1) / 32, Rows - 1);
+
+        for (int row = firstRow; row <= lastRow; row++) {
+            for (int column = firstColumn; column <= lastColumn; column++) {
+                Cells[column + row * Columns] = true;
+            }
+        }
+    }
+
+    void Merge(const std::vector<bool> &other) {
+        AbortUnless(other.size() == Cells.size());
+
+        for (size_t idx = 0; idx < Cells.size(); idx++) {
+            Cells[idx] = Cells[idx] || other[idx];
+        }
+    }
+
+    /* Clears the cells that are marked in `other`. */
+    void Subtract(const std::vector<bool> &other) {
+        AbortUnless(other.size() == Cells.size());
+
+        for (size_t idx = 0; idx < Cells.size(); idx++) {
+            Cells[idx] = Cells[idx] && !other[idx];
+        }
+    }
+
+    int Count() const {
+        return std::count(Cells.begin(), Cells.end(), true);
+    }
+
+    bool Empty() const {
+        return std::find(Cells.begin(), Cells.end(), true) == Cells.end();
+    }
+
+    void Summarize() {
+        const int stride = Columns + 1;
+
+        Sums.assign(stride * (Rows + 1), 0);
+
+        for (int row = 0; row < Rows; row++) {
+            for (int column = 0; column < Columns; column++) {
+                Sums[(column + 1) + (row + 1) * stride] =
+                        Cells[column + row * Columns] +
+                        Sums[column + (row + 1) * stride] +
+                        Sums[(column + 1) + row * stride] -
+                        Sums[column + row * stride];
+            }
+        }
+    }
+
+    /* Returns whether any marked cell overlaps the given rectangle. */
+    bool Intersects(int leftX, int topY, int rightX, int bottomY) const {
+        const int stride = Columns + 1;
+
+        if (rightX <= 0 || bottomY <= 0) {
+            return false;
+        }
+
+        const int firstColumn = std::max(leftX, 0) / 32;
+        const int firstRow = std::max(topY, 0) / 32;
+        const int endColumn = std::min((rightX + 31) / 32, Columns);
+        const int endRow = std::min((bottomY + 31) / 32, Rows);
+
+        if (firstColumn >= endColumn || firstRow >= endRow) {
+            return false;
+        }
+
+        return (Sums[endColumn + endRow * stride] -
+                Sums[firstColumn + endRow * stride] -
+                Sums[endColumn + firstRow * stride] +
+                Sums[firstColumn + firstRow * stride]) > 0;
+    }
+
+    /* Calls `function(leftX, topY, rightX, bottomY)` on a set of rectangles
+     * covering all marked cells. */
+    template <typename Function>
+    void ForEachRectangle(Function function) const {
+        std::vector<bool> pending = Cells;
+
+        for (int row = 0; row < Rows; row++) {
+            for (int column = 0; column < Columns; column++) {
+                if (!pending[column + row * Columns]) {
+                    continue;
+                }
+
+                int endColumn = column, endRow = row + 1;
+
+                while (endColumn < Columns &&
+                       pending[endColumn + row * Columns]) {
+                    pending[endColumn + row * Columns] = false;
+                    endColumn++;
+                }
+
+                /* Grow downwards for as long as the run continues below. */
+                while (endRow < Rows) {
+                    const auto first = pending.begin() + endRow * Columns;
+
+                    if (!std::all_of(first + column,
+                                     first + endColumn,
+                                     [](bool cell) { return cell; })) {
+                        break;
+                    }
+
+                    std::fill(first + column, first + endColumn, false);
+                    endRow++;
+                }
+
+                function(column * 32, row * 32, endColumn * 32, endRow * 32);
+            }
+        }
+    }
+};
+
+/* Returns how far to the right of its bottom-right corner the tile at
+ * `position` may draw. This is normally nothing, but tiles at the left edge of
+ * the view redraw the tops of their neighbors above and to the right instead
+ * of those to the left, see DrawFloors. */
+static int GetTileSpill(const Gamestate &gamestate, const Position &position) {
+    const int xyOffset = gamestate.Map.Position.Z - position.Z;
+
+    return (position.X == gamestate.Map.Position.X - 8 + xyOffset) ? 32 : 0;
+}
+
+/* Returns whether there are any missiles in flight on the given floor, see
+ * DrawMissiles. */
+static bool HasMissilesInFlight(const Gamestate &gamestate,
+                                int floor,
+                                uint32_t tick) {
+    unsigned missileIdx = gamestate.MissileIndex;
+
+    do {
+        missileIdx = (missileIdx - 1) % Gamestate::MaxMissiles;
+
+        const auto &missile = gamestate.MissileList[missileIdx];
+        uint32_t endTick = missile.StartTick + 200;
+
+        if (endTick < tick) {
+            break;
+        } else if (missile.Id != 0 && missile.Origin.Z == floor) {
+            return true;
+        }
+    } while (missileIdx != gamestate.MissileIndex);
+
+    return false;
+}
+
+/* Returns the tiles of the given floor that may draw anything, one bit per
+ * row for each column of the view. Besides their own contents, tiles draw the
+ * creatures walking onto their neighbors and missiles passing over them. */
+static std::array<uint32_t, 18> GetDrawnTiles(const Gamestate &gamestate,
+                                              int floor) {
+    constexpr int width = Map::TileBufferWidth;
+    constexpr int height = Map::TileBufferHeight;
+    constexpr uint32_t all = (1u << width) - 1;
+
+    /* Yields the row as seen from the `by`th column. */
+    const auto rotate = [](uint32_t row, int by) {
+        return ((row >> by) | (row << (width - by))) & all;
+    };
+
+    const auto &occupancy = gamestate.Map.GetOccupancy(floor);
+    std::array<uint32_t, 18> columns = {};
+
+    if (HasMissilesInFlight(gamestate, floor, gamestate.CurrentTick)) {
+        columns.fill((1u << height) - 1);
+        return columns;
+    } else if (occupancy.Empty()) {
+        return columns;
+    }
+
+    const int xyOffset = gamestate.Map.Position.Z - floor;
+    const int firstX = (gamestate.Map.Position.X - 8 + xyOffset) % width;
+    const int firstY = (gamestate.Map.Position.Y - 6 + xyOffset) % height;
+
+    for (int yIdx = 0; yIdx < height; yIdx++) {
+        const int row = (firstY + yIdx) % height;
+        uint32_t drawn = occupancy.Occupied[row];
+
+        /* The neighbors of the tiles at the edges of the view wrap around
+         * the tile buffer, just like the lookups in DrawMovingCreatures. */
+        for (int rowIdx = row - 1; rowIdx <= row + 1; rowIdx++) {
+            const uint32_t inhabited =
+                    occupancy.Inhabited[(rowIdx + height) % height];
+
+            drawn |= inhabited | rotate(inhabited, 1) |
+                     rotate(inhabited, width - 1);
+        }
+
+        drawn = rotate(drawn, firstX);
+
+        for (int xIdx = 0; xIdx < width; xIdx++) {
+            if (drawn & (1u << xIdx)) {
+                columns[xIdx] |= 1u << yIdx;
+            }
+        }
+    }
+
+    return columns;
+}
+
+/* Draws all visible floors, skipping tiles that cannot draw anything within
+ * the `dirty` cells when given, assuming that no tile draws further than
+ * `reach` pixels up and to the left of its bottom-right corner, nor further
+ * than GetTileSpill to the right. Empty tiles and tiles hidden by the floors
+ * above them are skipped as well, see GetDrawnTiles and FindHiddenTiles. */
+template <typename Settings, typename Target>
+static void DrawFloors(const Settings &options,
+                       Gamestate &gamestate,
+                       const View &view,
+                       const DirtyCells *dirty,
+                       int reach,
+                       Target &canvas) {
+    for (int zIdx = view.BottomFloor; zIdx >= view.TopFloor; zIdx--) {
+        const auto drawn = GetDrawnTiles(gamestate, zIdx);
+        int xyOffset = gamestate.Map.Position.Z - zIdx;
+
+        for (int xIdx = 0; xIdx <= 17; xIdx++) {
+            for (uint32_t rows = drawn[xIdx]; rows != 0; rows &= rows - 1) {
+                const int yIdx = std::countr_zero(rows);
                 Position position;
                 bool redrawNearbyTop;
 
@@ -1112,13 +1711,35 @@ void DrawGamestate(const Options &options,
                 position.Y = gamestate.Map.Position.Y - 6 + yIdx + xyOffset;
                 position.Z = zIdx;
 
+                if (view.Hidden[zIdx % Map::TileBufferDepth][yIdx] &
+                    (1u << xIdx)) {
+                    continue;
+                }
+
+                if (dirty != nullptr) {
+                    const int rightX =
+                            position.X * 32 + view.OffsetX - xyOffset * 32;
+                    const int bottomY =
+                            position.Y * 32 + view.OffsetY - xyOffset * 32;
+
+                    /* Note the extra tile for redrawing the tops of the
+                     * neighbors above and to the left. */
+                    if (!dirty->Intersects(rightX - reach - 32,
+                                           bottomY - reach - 32,
+                                           rightX + GetTileSpill(gamestate,
+                                                                 position),
+                                           bottomY)) {
+                        continue;
+                    }
+                }
+
                 redrawNearbyTop = false;
 
                 DrawTile(options,
                          gamestate,
                          position,
-                         viewOffsetX - xyOffset * 32,
-                         viewOffsetY - xyOffset * 32,
+                         view.OffsetX - xyOffset * 32,
+                         view.OffsetY - xyOffset * 32,
                          gamestate.CurrentTick,
                          &redrawNearbyTop,
                          canvas);
@@ -1130,8 +1751,8 @@ void DrawGamestate(const Options &options,
                         DrawTile(options,
                                  gamestate,
                                  position,
-                                 viewOffsetX - xyOffset * 32,
-                                 viewOffsetY - xyOffset * 32,
+                                 view.OffsetX - xyOffset * 32,
+                                 view.OffsetY - xyOffset * 32,
                                  gamestate.CurrentTick,
                                  &redrawNearbyTop,
                                  canvas);
@@ -1143,8 +1764,8 @@ void DrawGamestate(const Options &options,
                         DrawTile(options,
                                  gamestate,
                                  position,
-                                 viewOffsetX - xyOffset * 32,
-                                 viewOffsetY - xyOffset * 32,
+                                 view.OffsetX - xyOffset * 32,
+                                 view.OffsetY - xyOffset * 32,
                                  gamestate.CurrentTick,
                                  &redrawNearbyTop,
                                  canvas);
@@ -1154,8 +1775,8 @@ void DrawGamestate(const Options &options,
                         DrawTile(options,
                                  gamestate,
                                  position,
-                                 viewOffsetX - xyOffset * 32,
-                                 viewOffsetY - xyOffset * 32,
+                                 view.OffsetX - xyOffset * 32,
+                                 view.OffsetY - xyOffset * 32,
                                  gamestate.CurrentTick,
                                  &redrawNearbyTop,
                                  canvas);
@@ -1166,8 +1787,8 @@ void DrawGamestate(const Options &options,
                     DrawTile(options,
                              gamestate,
                              position,
-                             viewOffsetX - xyOffset * 32,
-                             viewOffsetY - xyOffset * 32,
+                             view.OffsetX - xyOffset * 32,
+                             view.OffsetY - xyOffset * 32,
                              gamestate.CurrentTick,
                              &redrawNearbyTop,
                              canvas);
@@ -1177,8 +1798,822 @@ void DrawGamestate(const Options &options,
     }
 }
 
+/* Returns how far up and to the left of its bottom-right corner a tile may
+ * draw, covering the largest type at its greatest displacement as well as
+ * creatures and missiles passing over the tile. */
+static int MeasureTileReach(const Version &version) {
+    /* Walking creatures and missiles are drawn up to a tile away from the
+     * tile drawing them, and the shimmer of invisible players is offset by
+     * another 8 pixels. */
+    return version.Types.MaxSize + version.Types.MaxDisplacement +
+           MAX_HEIGHT_DISPLACEMENT + 32 + 8;
+}
+
+void DrawGamestate(const Options &options,
+                   Gamestate &gamestate,
+                   Canvas &canvas) noexcept {
+    View view = PrepareView(options, gamestate);
+
+    UpdateRenderHeights(gamestate, view);
+    FindHiddenTiles(gamestate, MeasureTileReach(gamestate.Version), view);
+    DrawFloors(options, gamestate, view, nullptr, 0, canvas);
+}
+
+/* Calls `function(position, rightX, bottomY)` for every tile on the given
+ * floor, including a one-tile border around the view whose creatures may walk
+ * into it. */
+template <typename Function>
+static void ForEachFloorTile(const Gamestate &gamestate,
+                             const View &view,
+                             int floor,
+                             Function function) {
+    const int xyOffset = gamestate.Map.Position.Z - floor;
+
+    for (int xIdx = -1; xIdx <= 18; xIdx++) {
+        for (int yIdx = -1; yIdx <= 14; yIdx++) {
+            Position position(gamestate.Map.Position.X - 8 + xIdx + xyOffset,
+                              gamestate.Map.Position.Y - 6 + yIdx + xyOffset,
+                              floor);
+
+            function(position,
+                     position.X * 32 + view.OffsetX - xyOffset * 32,
+                     position.Y * 32 + view.OffsetY - xyOffset * 32);
+        }
+    }
+}
+
+/* Returns how far up and to the left of where it's drawn `type` may reach,
+ * at any height displacement. */
+static int MeasureTypeReach(const EntityType &type) {
+    int size = 32;
+
+    for (const auto &frameGroup : type.FrameGroups) {
+        if (frameGroup.Active) {
+            size = std::max<int>(
+                    {size, frameGroup.SizeX * 32, frameGroup.SizeY * 32});
+        }
+    }
+
+    return size +
+           std::max(type.Properties.DisplacementX,
+                    type.Properties.DisplacementY) +
+           MAX_HEIGHT_DISPLACEMENT;
+}
+
+static int MeasureCreatureReach(const Version &version,
+                                const Creature &creature) {
+    if (creature.Outfit.Id != 0) {
+        int reach = MeasureTypeReach(version.GetOutfit(creature.Outfit.Id));
+
+        if (creature.Outfit.MountId != 0) {
+            reach = std::max(reach,
+                             MeasureTypeReach(version.GetOutfit(
+                                     creature.Outfit.MountId)));
+        }
+
+        return reach;
+    } else if (creature.Outfit.Item.Id != 0) {
+        return MeasureTypeReach(version.GetItem(creature.Outfit.Item));
+    } else if (creature.Type == CreatureType::Player) {
+        /* Shimmer effect, see DrawCreature. */
+        return MeasureTypeReach(version.GetEffect(0x0D)) + 8;
+    }
+
+    return 0;
+}
+
+/* Marks the surroundings of everything on the given floor whose appearance
+ * depends on the current tick rather than the contents of the map. */
+static void MarkTickDriven(const Gamestate &gamestate,
+                           const View &view,
+                           int floor,
+                           DirtyCells &cells) {
+    const Version &version = gamestate.Version;
+    const uint32_t tick = gamestate.CurrentTick;
+
+    ForEachFloorTile(
+            gamestate,
+            view,
+            floor,
+            [&](const Position &position, int rightX, int bottomY) {
+                const auto &tile = gamestate.Map.Tile(position);
+
+                for (int objectIdx = 0; objectIdx < tile.ObjectCount;
+                     objectIdx++) {
+                    const auto &object = tile.Objects[objectIdx];
+
+                    if (object.IsCreature()) {
+                        auto creature =
+                                gamestate.FindCreature(object.CreatureId);
+
+                        if (creature != nullptr) {
+                            const int reach =
+                                    MeasureCreatureReach(version, *creature);
+
+                            /* Walking creatures may be up to a tile away in
+                             * any direction. */
+                            cells.Mark(rightX - reach - 32,
+                                       bottomY - reach - 32,
+                                       rightX + 32,
+                                       bottomY + 32);
+                        }
+                    } else {
+                        const auto &type = version.GetItem(object);
+
+                        if (type.Properties.Animated) {
+                            const int reach = MeasureTypeReach(type);
+
+                            cells.Mark(rightX - reach,
+                                       bottomY - reach,
+                                       rightX,
+                                       bottomY);
+                        }
+                    }
+                }
+
+                for (const auto &effect : tile.GraphicalEffects) {
+                    if (effect.Id > 0) {
+                        const auto &type = version.GetEffect(effect.Id);
+                        const auto &frameGroup =
+                                type.FrameGroups[std::to_underlying(
+                                        FrameGroupIndex::Default)];
+
+                        if ((effect.StartTick + 100 * frameGroup.FrameCount) >
+                            tick) {
+                            const int reach = MeasureTypeReach(type);
+
+                            cells.Mark(rightX - reach,
+                                       bottomY - reach,
+                                       rightX,
+                                       bottomY);
+                        }
+                    }
+                }
+            });
+
+    for (const auto &missile : gamestate.MissileList) {
+        if (missile.Id == 0 || (missile.StartTick + 200) < tick ||
+            missile.Origin.Z != floor) {
+            continue;
+        }
+
+        const int xyOffset = gamestate.Map.Position.Z - floor;
+        const int offsetX = view.OffsetX - xyOffset * 32;
+        const int offsetY = view.OffsetY - xyOffset * 32;
+
+        /* Missiles are drawn anywhere along their path, by the tile they're
+         * currently passing over. */
+        const int reach = MeasureTypeReach(version.GetMissile(missile.Id));
+
+        cells.Mark(std::min(missile.Origin.X, missile.Target.X) * 32 +
+                           offsetX - reach,
+                   std::min(missile.Origin.Y, missile.Target.Y) * 32 +
+                           offsetY - reach,
+                   std::max(missile.Origin.X, missile.Target.X) * 32 + offsetX,
+                   std::max(missile.Origin.Y, missile.Target.Y) * 32 +
+                           offsetY);
+    }
+}
+
+/* Marks the surroundings of all tiles that have been touched since the
+ * given map revision. */
+static void MarkTouched(const Gamestate &gamestate,
+                        const View &view,
+                        uint32_t revision,
+                        int reach,
+                        DirtyCells &cells) {
+    for (int zIdx = view.BottomFloor; zIdx >= view.TopFloor; zIdx--) {
+        ForEachFloorTile(
+                gamestate,
+                view,
+                zIdx,
+                [&](const Position &position, int rightX, int bottomY) {
+                    if (gamestate.Map.GetRevision(position.X,
+                                                  position.Y,
+                                                  position.Z) > revision) {
+                        /* Changes to this tile may also redraw the tops of
+                         * its neighbors above and to the left. */
+                        cells.Mark(rightX - reach - 32,
+                                   bottomY - reach - 32,
+                                   rightX + GetTileSpill(gamestate, position),
+                                   bottomY);
+                    }
+                });
+    }
+}
+
+/* Margin in pixels around the game view in floor layers, letting them be
+ * reused while the player walks to a neighboring tile. */
+#define FLOOR_LAYER_MARGIN 32
+
+/* Returns the view that floor layers are drawn with: that of the player
+ * standing still, offset by the margin. */
+static View GetLayerView(const Gamestate &gamestate, int floor) {
+    View view;
+
+    view.OffsetX = (8 - gamestate.Map.Position.X) * 32 + FLOOR_LAYER_MARGIN;
+    view.OffsetY = (6 - gamestate.Map.Position.Y) * 32 + FLOOR_LAYER_MARGIN;
+    view.TopFloor = floor;
+    view.BottomFloor = floor;
+
+    return view;
+}
+
+/* Classifies the cells of `layer` that are marked in `cells`, or all of them
+ * if none are given. */
+static void ClassifyLayer(FloorLayer &layer, const DirtyCells *cells) {
+    const Canvas &image = *layer.Image;
+    const int columns = (image.Width + 31) / 32;
+    const int rows = (image.Height + 31) / 32;
+
+    layer.Coverage.resize(columns * rows);
+
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            if (cells != nullptr && !cells->Cells[column + row * columns]) {
+                continue;
+            }
+
+            const int cellWidth = std::min(32, image.Width - column * 32);
+            const int cellHeight = std::min(32, image.Height - row * 32);
+            uint8_t lowest = 0xFF, highest = 0;
+
+            for (int yIdx = 0; yIdx < cellHeight; yIdx++) {
+                const Pixel *pixels =
+                        &image.GetPixel(column * 32, row * 32 + yIdx);
+
+                for (int xIdx = 0; xIdx < cellWidth; xIdx++) {
+                    lowest = std::min(lowest, pixels[xIdx].Alpha);
+                    highest = std::max(highest, pixels[xIdx].Alpha);
+                }
+            }
+
+            if (highest != 0xFF) {
+                layer.Coverage[column + row * columns] =
+                        Sprite::Coverage::Empty;
+            } else if (lowest == 0xFF) {
+                layer.Coverage[column + row * columns] =
+                        Sprite::Coverage::Opaque;
+            } else {
+                layer.Coverage[column + row * columns] =
+                        Sprite::Coverage::Masked;
+            }
+        }
+    }
+}
+
+/* Marks the tiles that have entered or left the given floor layer since the
+ * player moved from `from`, or whose neighbors' tops are redrawn differently
+ * now that they are at the edge of the view or no longer are, see
+ * GetTileSpill. */
+static void MarkScrolled(const Gamestate &gamestate,
+                         const View &layerView,
+                         int floor,
+                         const Position &from,
+                         int reach,
+                         DirtyCells &cells) {
+    const Position &to = gamestate.Map.Position;
+    const int xyOffset = to.Z - floor;
+
+    const int fromX = from.X - 8 + xyOffset, fromY = from.Y - 6 + xyOffset;
+    const int toX = to.X - 8 + xyOffset, toY = to.Y - 6 + xyOffset;
+
+    for (int x = std::min(fromX, toX); x <= std::max(fromX, toX) + 17; x++) {
+        for (int y = std::min(fromY, toY); y <= std::max(fromY, toY) + 13;
+             y++) {
+            const bool wasVisible = (x - fromX) >= 0 && (x - fromX) <= 17 &&
+                                    (y - fromY) >= 0 && (y - fromY) <= 13;
+            const bool isVisible = (x - toX) >= 0 && (x - toX) <= 17 &&
+                                   (y - toY) >= 0 && (y - toY) <= 13;
+            const bool wasEdge = x == fromX || y == fromY;
+            const bool isEdge = x == toX || y == toY;
+
+            if (wasVisible != isVisible || (wasVisible && wasEdge) ||
+                (isVisible && isEdge)) {
+                const int rightX = x * 32 + layerView.OffsetX - xyOffset * 32;
+                const int bottomY =
+                        y * 32 + layerView.OffsetY - xyOffset * 32;
+                const int spill = (x == fromX || x == toX) ? 32 : 0;
+
+                cells.Mark(rightX - reach - 32,
+                           bottomY - reach - 32,
+                           rightX + spill,
+                           bottomY);
+            }
+        }
+    }
+}
+
+/* Returns the static layer of the given floor. Should the player have moved
+ * since it was last drawn, it is scrolled along, and then the tiles that
+ * have been touched or scrolled into view are redrawn. */
+/* Animated items are left in as they only draw within cells that are drawn
+ * from scratch every frame, see MarkTickDriven. */
+static constexpr Options GetLayerOptions(Options options) {
+    options.SkipRenderingCreatures = true;
+    options.SkipRenderingGraphicalEffects = true;
+    options.SkipRenderingMissiles = true;
+
+    return options;
+}
+
+template <Options Flags>
+static FixedOptions<GetLayerOptions(Flags)> GetLayerOptions(
+        const FixedOptions<Flags> &options) {
+    return GetLayerOptions(static_cast<const Options &>(options));
+}
+
+template <typename Settings>
+static const FloorLayer &RefreshLayer(const Settings &options,
+                                      Gamestate &gamestate,
+                                      int floor,
+                                      int reach,
+                                      ViewState &state) {
+    FloorLayer &layer = state.Layers[floor % Map::TileBufferDepth];
+    const Position &position = gamestate.Map.Position;
+    const View layerView = GetLayerView(gamestate, floor);
+    const auto layerOptions = GetLayerOptions(options);
+
+    const int scrollX = (layer.Position.X - position.X) * 32;
+    const int scrollY = (layer.Position.Y - position.Y) * 32;
+
+    if (!layer.Valid || layer.Floor != floor ||
+        layer.Position.Z != position.Z ||
+        std::abs(scrollX) >= layer.Image->Width ||
+        std::abs(scrollY) >= layer.Image->Height) {
+        Canvas &image = *layer.Image;
+
+        image.Wipe();
+        DrawFloors(layerOptions, gamestate, layerView, nullptr, 0, image);
+        ClassifyLayer(layer, nullptr);
+    } else {
+        DirtyCells touched(*layer.Image);
+
+        if (scrollX != 0 || scrollY != 0) {
+            const int width = layer.Image->Width;
+            const int height = layer.Image->Height;
+
+            state.LayerScratch->Blit(*layer.Image,
+                                     0,
+                                     0,
+                                     scrollX,
+                                     scrollY,
+                                     width,
+                                     height);
+            std::swap(layer.Image, state.LayerScratch);
+
+            /* As we scroll by whole tiles, the cells stay aligned. */
+            const int columns = (width + 31) / 32, rows = (height + 31) / 32;
+            std::vector<Sprite::Coverage> coverage(columns * rows,
+                                                   Sprite::Coverage::Masked);
+
+            for (int row = 0; row < rows; row++) {
+                for (int column = 0; column < columns; column++) {
+                    const int fromColumn = column - scrollX / 32;
+                    const int fromRow = row - scrollY / 32;
+
+                    if (fromColumn >= 0 && fromColumn < columns &&
+                        fromRow >= 0 && fromRow < rows) {
+                        coverage[column + row * columns] =
+                                layer.Coverage[fromColumn + fromRow * columns];
+                    }
+                }
+            }
+
+            layer.Coverage = std::move(coverage);
+
+            /* Whatever has been scrolled into view is covered by the tiles
+             * that entered it, but we'll mark it explicitly in case their
+             * reach falls short. */
+            touched.Mark(0, 0, scrollX, height);
+            touched.Mark(width + scrollX, 0, width, height);
+            touched.Mark(0, 0, width, scrollY);
+            touched.Mark(0, height + scrollY, width, height);
+
+            MarkScrolled(gamestate,
+                         layerView,
+                         floor,
+                         layer.Position,
+                         reach,
+                         touched);
+        }
+
+        ForEachFloorTile(
+                gamestate,
+                layerView,
+                floor,
+                [&](const Position &tilePosition, int rightX, int bottomY) {
+                    if (gamestate.Map.GetRevision(tilePosition.X,
+                                                  tilePosition.Y,
+                                                  tilePosition.Z) >
+                        layer.Revision) {
+                        touched.Mark(rightX - reach - 32,
+                                     bottomY - reach - 32,
+                                     rightX + GetTileSpill(gamestate,
+                                                           tilePosition),
+                                     bottomY);
+                    }
+                });
+
+        if (!touched.Empty()) {
+            Canvas &image = *layer.Image;
+            Canvas &scratch = *state.LayerScratch;
+
+            touched.Summarize();
+            touched.ForEachRectangle(
+                    [&](int leftX, int topY, int rightX, int bottomY) {
+                        scratch.Fill(Pixel::Transparent(),
+                                     leftX,
+                                     topY,
+                                     rightX - leftX,
+                                     bottomY - topY);
+                    });
+
+            DrawFloors(layerOptions,
+                       gamestate,
+                       layerView,
+                       &touched,
+                       reach,
+                       scratch);
+
+            touched.ForEachRectangle(
+                    [&](int leftX, int topY, int rightX, int bottomY) {
+                        image.Blit(scratch,
+                                   leftX,
+                                   topY,
+                                   leftX,
+                                   topY,
+                                   rightX - leftX,
+                                   bottomY - topY);
+                    });
+
+            ClassifyLayer(layer, &touched);
+        }
+    }
+
+    layer.Position = position;
+    layer.Floor = floor;
+    layer.Revision = gamestate.Map.GetRevision();
+    layer.Valid = true;
+
+    return layer;
+}
+
+/* Composites the given rectangle of `layer` onto `canvas`, where the layer is
+ * offset by (shiftX, shiftY) from the canvas. */
+template <typename Target>
+static void CompositeLayer(const FloorLayer &layer,
+                           int shiftX,
+                           int shiftY,
+                           int leftX,
+                           int topY,
+                           int rightX,
+                           int bottomY,
+                           Target &canvas) {
+    const int columns = (layer.Image->Width + 31) / 32;
+
+    leftX = std::max(leftX, 0) + shiftX;
+    topY = std::max(topY, 0) + shiftY;
+    rightX = std::min(rightX, canvas.Width) + shiftX;
+    bottomY = std::min(bottomY, canvas.Height) + shiftY;
+
+    for (int row = topY / 32; row * 32 < bottomY; row++) {
+        const auto *coverage = &layer.Coverage[row * columns];
+        const int fromY = std::max(row * 32, topY);
+        const int toY = std::min((row + 1) * 32, bottomY);
+
+        /* Handle runs of equally covered cells together. */
+        for (int column = leftX / 32, end; column * 32 < rightX;
+             column = end) {
+            end = column + 1;
+
+            while (end * 32 < rightX && coverage[end] == coverage[column]) {
+                end++;
+            }
+
+            if (coverage[column] == Sprite::Coverage::Empty) {
+                continue;
+            }
+
+            const int fromX = std::max(column * 32, leftX);
+            const int toX = std::min(end * 32, rightX);
+
+            if (coverage[column] == Sprite::Coverage::Opaque) {
+                canvas.Blit(*layer.Image,
+                            fromX,
+                            fromY,
+                            fromX - shiftX,
+                            fromY - shiftY,
+                            toX - fromX,
+                            toY - fromY);
+            } else {
+                canvas.Composite(*layer.Image,
+                                 fromX,
+                                 fromY,
+                                 fromX - shiftX,
+                                 fromY - shiftY,
+                                 toX - fromX,
+                                 toY - fromY);
+            }
+        }
+    }
+}
+
+/* Draws all visible floors into `canvas`, bottom to top.
+ *
+ * Floors where only a small part of the view holds tick-driven content,
+ * `live`, have their static layer composited as-is outside of it. Within it,
+ * the tiles that may draw there are drawn in the usual painter's order before
+ * compositing the rest of the floor, which also covers whatever static
+ * content these tiles drew outside of it. */
+template <typename Settings, typename Target>
+static void ComposeFloors(const Settings &options,
+                          Gamestate &gamestate,
+                          const View &view,
+                          std::vector<DirtyCells> &live,
+                          int reach,
+                          ViewState &state,
+                          Target &canvas) {
+    std::vector<const FloorLayer *> layers(live.size(), nullptr);
+
+    /* Layers cover a walk to a neighboring tile, should the player move
+     * further than that (e.g. while being pushed into a teleport), we'll
+     * draw everything from scratch. */
+    const int shiftX = GetLayerView(gamestate, 0).OffsetX - view.OffsetX;
+    const int shiftY = GetLayerView(gamestate, 0).OffsetY - view.OffsetY;
+    const bool layered = shiftX >= 0 && shiftX <= FLOOR_LAYER_MARGIN * 2 &&
+                         shiftY >= 0 && shiftY <= FLOOR_LAYER_MARGIN * 2;
+
+    for (int zIdx = view.BottomFloor; zIdx >= view.TopFloor; zIdx--) {
+        const FloorLayer *layer = nullptr;
+        DirtyCells &drawn = live[zIdx - view.TopFloor];
+        View floorView = view;
+
+        floorView.TopFloor = zIdx;
+        floorView.BottomFloor = zIdx;
+
+        /* Compositing a layer on top of the tiles we'd have to draw anyway
+         * is slower than drawing the rest of the tiles as well, so we'll
+         * only bother when most of the floor can be left as-is. */
+        if (layered && drawn.Count() * 2 <= drawn.Columns * drawn.Rows) {
+            layer = &RefreshLayer(options, gamestate, zIdx, reach, state);
+        } else {
+            drawn.Mark(0, 0, canvas.Width, canvas.Height);
+        }
+
+        drawn.Summarize();
+
+        if (!drawn.Empty()) {
+            DrawFloors(options, gamestate, floorView, &drawn, reach, canvas);
+        }
+
+        if (layer != nullptr) {
+            DirtyCells composited(canvas);
+
+            composited.Mark(0, 0, canvas.Width, canvas.Height);
+            composited.Subtract(drawn.Cells);
+
+            composited.ForEachRectangle(
+                    [&](int leftX, int topY, int rightX, int bottomY) {
+                        CompositeLayer(*layer,
+                                       shiftX,
+                                       shiftY,
+                                       leftX,
+                                       topY,
+                                       rightX,
+                                       bottomY,
+                                       canvas);
+                    });
+        }
+    }
+}
+
+template <typename Settings>
+static void DrawView(const Settings &options,
+                     Gamestate &gamestate,
+                     ViewState &state,
+                     Canvas &canvas) {
+    View view = PrepareView(options, gamestate);
+
+    const int reach = MeasureTileReach(gamestate.Version);
+
+    UpdateRenderHeights(gamestate, view);
+    FindHiddenTiles(gamestate, reach, view);
+
+    DirtyCells dirty(canvas), tickDriven(canvas);
+    std::vector<DirtyCells> live;
+
+    for (int zIdx = view.TopFloor; zIdx <= view.BottomFloor; zIdx++) {
+        live.emplace_back(canvas);
+        MarkTickDriven(gamestate, view, zIdx, live.back());
+        tickDriven.Merge(live.back().Cells);
+    }
+
+    if (!state.Scratch || state.Scratch->Width != canvas.Width ||
+        state.Scratch->Height != canvas.Height) {
+        const int width = canvas.Width + FLOOR_LAYER_MARGIN * 2;
+        const int height = canvas.Height + FLOOR_LAYER_MARGIN * 2;
+
+        state.Scratch = std::make_unique<Canvas>(canvas.Width, canvas.Height);
+        state.LayerScratch = std::make_unique<Canvas>(width, height);
+
+        for (auto &layer : state.Layers) {
+            layer.Image = std::make_unique<Canvas>(width, height);
+            layer.Valid = false;
+        }
+    }
+
+    if (state.Map != &gamestate.Map || state.Options != options ||
+        state.Revision > gamestate.Map.GetRevision()) {
+        for (auto &layer : state.Layers) {
+            layer.Valid = false;
+        }
+    }
+
+    if (state.Map != &gamestate.Map || state.Buffer != canvas.Buffer ||
+        state.Width != canvas.Width || state.Height != canvas.Height ||
+        state.Options != options || state.Position != gamestate.Map.Position ||
+        state.ViewOffsetX != view.OffsetX ||
+        state.ViewOffsetY != view.OffsetY || state.TopFloor != view.TopFloor ||
+        state.BottomFloor != view.BottomFloor ||
+        state.Revision > gamestate.Map.GetRevision()) {
+        /* Wipe the background in the same manner Tibia does it, leaving
+         * empty spots on the map black. */
+        DisplayList &list = state.List;
+
+        list.Reset(canvas.Width, canvas.Height);
+        list.Fill(Pixel(0, 0, 0), 0, 0, canvas.Width, canvas.Height);
+        ComposeFloors(options, gamestate, view, live, reach, state, list);
+        list.Rasterize(canvas);
+    } else {
+        /* The few cells redrawn here are mostly tick-driven anyway, so we'll
+         * leave the floor layers to full redraws. */
+        MarkTouched(gamestate, view, state.Revision, reach, dirty);
+        dirty.Merge(state.Volatile);
+        dirty.Merge(tickDriven.Cells);
+        dirty.Summarize();
+
+        /* Tiles that overlap the dirty cells will also draw outside of them,
+         * so we draw into a scratch canvas and copy the dirty cells back
+         * from there. */
+        Canvas &scratch = *state.Scratch;
+        DisplayList &list = state.List;
+
+        list.Reset(scratch.Width, scratch.Height);
+
+        dirty.ForEachRectangle(
+                [&](int leftX, int topY, int rightX, int bottomY) {
+                    list.Fill(Pixel(0, 0, 0),
+                              leftX,
+                              topY,
+                              rightX - leftX,
+                              bottomY - topY);
+                });
+
+        DrawFloors(options, gamestate, view, &dirty, reach, list);
+        list.Rasterize(scratch);
+
+        dirty.ForEachRectangle(
+                [&](int leftX, int topY, int rightX, int bottomY) {
+                    canvas.Blit(scratch,
+                                leftX,
+                                topY,
+                                leftX,
+                                topY,
+                                rightX - leftX,
+                                bottomY - topY);
+                });
+    }
+
+    /* Sprites drawn into our own canvases count towards the one we were
+     * asked to draw on. */
+    for (Canvas *internal : {state.Scratch.get(), state.LayerScratch.get()}) {
+        canvas.Blits += internal->Blits;
+        internal->Blits = {};
+    }
+
+    for (auto &layer : state.Layers) {
+        canvas.Blits += layer.Image->Blits;
+        layer.Image->Blits = {};
+    }
+
+    state.Map = &gamestate.Map;
+    state.Buffer = canvas.Buffer;
+    state.Width = canvas.Width;
+    state.Height = canvas.Height;
+    state.Options = options;
+    state.Position = gamestate.Map.Position;
+    state.ViewOffsetX = view.OffsetX;
+    state.ViewOffsetY = view.OffsetY;
+    state.TopFloor = view.TopFloor;
+    state.BottomFloor = view.BottomFloor;
+    state.Revision = gamestate.Map.GetRevision();
+    state.Volatile = std::move(tickDriven.Cells);
+}
+
+template <Preset P>
+void DrawGamestate(const Options &options,
+                   Gamestate &gamestate,
+                   ViewState &state,
+                   Canvas &canvas) noexcept {
+    DrawView(PresetOptions<P>(options), gamestate, state, canvas);
+}
+
+template void DrawGamestate<Preset::Custom>(const Options &,
+                                            Gamestate &,
+                                            ViewState &,
+                                            Canvas &) noexcept;
+template void DrawGamestate<Preset::Default>(const Options &,
+                                             Gamestate &,
+                                             ViewState &,
+                                             Canvas &) noexcept;
+template void DrawGamestate<Preset::MapOnly>(const Options &,
+                                             Gamestate &,
+                                             ViewState &,
+                                             Canvas &) noexcept;
+template void DrawGamestate<Preset::NoText>(const Options &,
+                                            Gamestate &,
+                                            ViewState &,
+                                            Canvas &) noexcept;
+template void DrawGamestate<Preset::Minimap>(const Options &,
+                                             Gamestate &,
+                                             ViewState &,
+                                             Canvas &) noexcept;
+
+void DrawGamestate(const Options &options,
+                   Gamestate &gamestate,
+                   ViewState &state,
+                   Canvas &canvas) noexcept {
+    /* Indexed by preset. */
+    static constexpr std::array specializations = {
+            &DrawGamestate<Preset::Custom>,
+            &DrawGamestate<Preset::Default>,
+            &DrawGamestate<Preset::MapOnly>,
+            &DrawGamestate<Preset::NoText>,
+            &DrawGamestate<Preset::Minimap>};
+
+    specializations[std::to_underlying(GetPreset(options))](options,
+                                                            gamestate,
+                                                            state,
+                                                            canvas);
+}
+
+/* Draws text through `texts` when given, and as-is otherwise. */
+static void RenderText(TextRenderer::Cache *texts,
+                       const Font &font,
+                       TextAlignment alignment,
+                       TextTransform transform,
+                       const Pixel &color,
+                       int X,
+                       int Y,
+                       size_t lineMaxLength,
+                       const std::string &text,
+                       Canvas &canvas) {
+    if (texts != nullptr) {
+        texts->Render(font,
+                      alignment,
+                      transform,
+                      color,
+                      X,
+                      Y,
+                      lineMaxLength,
+                      text,
+                      canvas);
+    } else {
+        TextRenderer::Render(font,
+                             alignment,
+                             transform,
+                             color,
+                             X,
+                             Y,
+                             lineMaxLength,
+                             text,
+                             canvas);
+    }
+}
+
+static std::pair<size_t, size_t> MeasureText(TextRenderer::Cache *texts,
+                                             const Font &font,
+                                             TextAlignment alignment,
+                                             TextTransform transform,
+                                             const Pixel &color,
+                                             size_t lineMaxLength,
+                                             const std::string &text) {
+    if (texts != nullptr) {
+        return texts->MeasureBounds(font,
+                                    alignment,
+                                    transform,
+                                    color,
+                                    lineMaxLength,
+                                    text);
+    }
+
+    return TextRenderer::MeasureBounds(font, transform, lineMaxLength, text);
+}
+
 static void DrawNumericalEffects(Gamestate &gamestate,
                                  Canvas &canvas,
+                                 TextRenderer::Cache *texts,
                                  int viewOffsetX,
                                  int viewOffsetY,
                                  float scaleX,
@@ -1213,19 +2648,25 @@ static void DrawNumericalEffects(Gamestate &gamestate,
             effectShuntX += 2 + (int)(scaleX * 9.0f);
             effectShuntY += 0;
 
-            TextRenderer::DrawCenteredString(gamestate.Version.Fonts.Game,
-                                             Convert8BitColor(effect.Color),
-                                             textCenterX,
-                                             textCenterY,
-                                             std::format("{}", effect.Value),
-                                             canvas);
+            RenderText(texts,
+                       gamestate.Version.Fonts.Game,
+                       TextAlignment::Center,
+                       TextTransform::None,
+                       Convert8BitColor(effect.Color),
+                       textCenterX,
+                       textCenterY,
+                       ~(size_t)0,
+                       std::format("{}", effect.Value),
+                       canvas);
         }
     } while (effectIdx != tile.NumericalIndex);
 }
 
-static void DrawCreatureOverlay(const Options &options,
+template <typename Settings>
+static void DrawCreatureOverlay(const Settings &options,
                                 Gamestate &gamestate,
                                 Canvas &canvas,
+                                TextRenderer::Cache *texts,
                                 int isObscured,
                                 int heightDisplacement,
                                 int rightX,
@@ -1277,12 +2718,16 @@ static void DrawCreatureOverlay(const Options &options,
         nameCenterX = std::max(2.f, (creatureRX - 32) * scaleX + (16 * scaleX));
         nameCenterY = std::max(2.f, (creatureBY - 32) * scaleY - 16);
 
-        TextRenderer::DrawCenteredProperCaseString(version.Fonts.Game,
-                                                   infoColor,
-                                                   nameCenterX,
-                                                   nameCenterY,
-                                                   creature.Name,
-                                                   canvas);
+        RenderText(texts,
+                   version.Fonts.Game,
+                   TextAlignment::Center,
+                   TextTransform::ProperCase,
+                   infoColor,
+                   nameCenterX,
+                   nameCenterY,
+                   ~(size_t)0,
+                   creature.Name,
+                   canvas);
     }
 
     if (!options.SkipRenderingCreatureHealthBars) {
@@ -1400,9 +2845,11 @@ static void DrawCreatureOverlay(const Options &options,
     }
 }
 
-static bool DrawTileOverlay(const Options &options,
+template <typename Settings>
+static bool DrawTileOverlay(const Settings &options,
                             Gamestate &gamestate,
                             Canvas &canvas,
+                            TextRenderer::Cache *texts,
                             int isObscured,
                             int rightX,
                             int bottomY,
@@ -1420,7 +2867,7 @@ static bool DrawTileOverlay(const Options &options,
             continue;
         }
 
-        const auto &item = version.GetItem(object.Id);
+        const auto &item = version.GetItem(object);
 
         if (item.Properties.StackPriority != 3) {
             heightDisplacement =
@@ -1444,6 +2891,7 @@ static bool DrawTileOverlay(const Options &options,
                 DrawCreatureOverlay(options,
                                     gamestate,
                                     canvas,
+                                    texts,
                                     isObscured,
                                     heightDisplacement,
                                     rightX,
@@ -1458,9 +2906,11 @@ static bool DrawTileOverlay(const Options &options,
     return true;
 }
 
-static bool DrawMapOverlay(const Options &options,
+template <typename Settings>
+static bool DrawMapOverlay(const Settings &options,
                            Gamestate &gamestate,
                            Canvas &canvas,
+                           TextRenderer::Cache *texts,
                            int viewOffsetX,
                            int viewOffsetY,
                            float scaleX,
@@ -1502,6 +2952,7 @@ static bool DrawMapOverlay(const Options &options,
                 DrawTileOverlay(options,
                                 gamestate,
                                 canvas,
+                                texts,
                                 isObscured,
                                 rightX,
                                 bottomY,
@@ -1513,6 +2964,7 @@ static bool DrawMapOverlay(const Options &options,
             if (!options.SkipRenderingNumericalEffects) {
                 DrawNumericalEffects(gamestate,
                                      canvas,
+                                     texts,
                                      viewOffsetX,
                                      viewOffsetY,
                                      scaleX,
@@ -1526,9 +2978,11 @@ static bool DrawMapOverlay(const Options &options,
     return true;
 }
 
-static bool DrawMessages(const Options &options,
+template <typename Settings>
+static bool DrawMessages(const Settings &options,
                          Gamestate &gamestate,
                          Canvas &canvas,
+                         TextRenderer::Cache *texts,
                          int viewOffsetX,
                          int viewOffsetY,
                          float scaleX,
@@ -1724,23 +3178,26 @@ static bool DrawMessages(const Options &options,
             }
         }
 
-        auto [textWidth, textHeight] =
-                TextRenderer::MeasureBounds(version.Fonts.Game,
-                                            transform,
-                                            lineMaxLength,
-                                            message->Text);
+        auto [textWidth, textHeight] = MeasureText(texts,
+                                                   version.Fonts.Game,
+                                                   TextAlignment::Center,
+                                                   transform,
+                                                   messageColor,
+                                                   lineMaxLength,
+                                                   message->Text);
 
         bottomY -= textHeight;
 
-        TextRenderer::Render(version.Fonts.Game,
-                             TextAlignment::Center,
-                             transform,
-                             messageColor,
-                             centerX,
-                             bottomY,
-                             lineMaxLength,
-                             message->Text,
-                             canvas);
+        RenderText(texts,
+                   version.Fonts.Game,
+                   TextAlignment::Center,
+                   transform,
+                   messageColor,
+                   centerX,
+                   bottomY,
+                   lineMaxLength,
+                   message->Text,
+                   canvas);
 
         std::tie(preserveCoordinates, canMerge) =
                 gamestate.Messages.QueryNext(message);
@@ -1772,13 +3229,18 @@ static bool DrawMessages(const Options &options,
             if (messagePrefix != NULL) {
                 bottomY -= version.Fonts.Game.Height;
 
-                TextRenderer::DrawCenteredString(
-                        version.Fonts.Game,
-                        messageColor,
-                        centerX,
-                        bottomY,
-                        std::format("{} {}:", message->Author, messagePrefix),
-                        canvas);
+                RenderText(texts,
+                           version.Fonts.Game,
+                           TextAlignment::Center,
+                           TextTransform::None,
+                           messageColor,
+                           centerX,
+                           bottomY,
+                           ~(size_t)0,
+                           std::format("{} {}:",
+                                       message->Author,
+                                       messagePrefix),
+                           canvas);
             }
         }
     }
@@ -1786,9 +3248,11 @@ static bool DrawMessages(const Options &options,
     return true;
 }
 
-void DrawOverlay(const Options &options,
-                 Gamestate &gamestate,
-                 Canvas &canvas) noexcept {
+template <typename Settings>
+static void DrawOverlay(const Settings &options,
+                        Gamestate &gamestate,
+                        TextRenderer::Cache *texts,
+                        Canvas &canvas) {
     int viewOffsetX, viewOffsetY;
     float scaleX, scaleY;
 
@@ -1806,6 +3270,7 @@ void DrawOverlay(const Options &options,
         DrawMapOverlay(options,
                        gamestate,
                        canvas,
+                       texts,
                        viewOffsetX,
                        viewOffsetY,
                        scaleX,
@@ -1816,6 +3281,7 @@ void DrawOverlay(const Options &options,
         DrawMessages(options,
                      gamestate,
                      canvas,
+                     texts,
                      viewOffsetX,
                      viewOffsetY,
                      scaleX,
@@ -1823,6 +3289,60 @@ void DrawOverlay(const Options &options,
     }
 }
 
+void DrawOverlay(const Options &options,
+                 Gamestate &gamestate,
+                 Canvas &canvas) noexcept {
+    DrawOverlay(options, gamestate, nullptr, canvas);
+}
+
+template <Preset P>
+void DrawOverlay(const Options &options,
+                 Gamestate &gamestate,
+                 TextRenderer::Cache &texts,
+                 Canvas &canvas) noexcept {
+    texts.Prune(gamestate.Messages.GetGeneration());
+    DrawOverlay(PresetOptions<P>(options), gamestate, &texts, canvas);
+}
+
+template void DrawOverlay<Preset::Custom>(const Options &,
+                                          Gamestate &,
+                                          TextRenderer::Cache &,
+                                          Canvas &) noexcept;
+template void DrawOverlay<Preset::Default>(const Options &,
+                                           Gamestate &,
+                                           TextRenderer::Cache &,
+                                           Canvas &) noexcept;
+template void DrawOverlay<Preset::MapOnly>(const Options &,
+                                           Gamestate &,
+                                           TextRenderer::Cache &,
+                                           Canvas &) noexcept;
+template void DrawOverlay<Preset::NoText>(const Options &,
+                                          Gamestate &,
+                                          TextRenderer::Cache &,
+                                          Canvas &) noexcept;
+template void DrawOverlay<Preset::Minimap>(const Options &,
+                                           Gamestate &,
+                                           TextRenderer::Cache &,
+                                           Canvas &) noexcept;
+
+void DrawOverlay(const Options &options,
+                 Gamestate &gamestate,
+                 TextRenderer::Cache &texts,
+                 Canvas &canvas) noexcept {
+    /* Indexed by preset. */
+    static constexpr std::array specializations = {
+            &DrawOverlay<Preset::Custom>,
+            &DrawOverlay<Preset::Default>,
+            &DrawOverlay<Preset::MapOnly>,
+            &DrawOverlay<Preset::NoText>,
+            &DrawOverlay<Preset::Minimap>};
+
+    specializations[std::to_underlying(GetPreset(options))](options,
+                                                            gamestate,
+                                                            texts,
+                                                            canvas);
+}
+
 int MeasureIconBarHeight(Gamestate &gamestate) noexcept {
     const Icons &icons = gamestate.Version.Icons;
 
@@ -2283,17 +3803,44 @@ void DrawClientBackground(Gamestate &gamestate,
                           int topY,
                           int rightX,
                           int bottomY) noexcept {
-    const auto &sprite = gamestate.Version.Icons.ClientBackground;
+    canvas.TileFill(gamestate.Version.Icons.ClientBackground,
+                    leftX,
+                    topY,
+                    rightX - leftX,
+                    bottomY - topY);
+}
 
-    for (int toY = topY; toY < bottomY; toY += sprite.Height) {
-        for (int toX = leftX; toX < rightX; toX += sprite.Width) {
-            canvas.Draw(sprite,
-                        toX,
-                        toY,
-                        std::min(sprite.Width, rightX - toX),
-                        std::min(sprite.Height, bottomY - toY));
+bool UpdateInterfaceState(Gamestate &gamestate,
+                          InterfaceState &state) noexcept {
+    const Version &version = gamestate.Version;
+
+    if (!state.Drawn || state.Generation != gamestate.InterfaceGeneration) {
+        state.Generation = gamestate.InterfaceGeneration;
+        state.Drawn = true;
+        return true;
+    }
+
+    /* Animated items change with the tick alone, so we can't skip drawing
+     * while any of them are shown. */
+    auto isAnimated = [&](const Object &item) {
+        return item.Id != 0 && version.GetItem(item).Properties.Animated;
+    };
+
+    for (auto slot = std::to_underlying(InventorySlot::First);
+         slot <= std::to_underlying(InventorySlot::Last);
+         slot++) {
+        if (isAnimated(gamestate.Player.Inventory(InventorySlot(slot)))) {
+            return true;
         }
     }
+
+    for (const auto &[_, container] : gamestate.Containers) {
+        if (std::ranges::any_of(container.Items, isAnimated)) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 void DumpItem(Version &version, uint16_t item, Canvas &canvas) noexcept {
@@ -21,10 +21,15 @@
 #ifndef __TRC_RENDERER_HPP__
 #define __TRC_RENDERER_HPP__
 
+#include <array>
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "canvas.hpp"
+#include "displaylist.hpp"
 #include "gamestate.hpp"
+#include "textrenderer.hpp"
 
 namespace trc {
 namespace Renderer {
@@ -37,6 +42,12 @@ struct Options {
     int Width;
     int Height;
 
+    /* Memory cap in bytes for the cache of tinted outfits. As the cache is
+     * shared by everything rendering against the same version, it grows to
+     * the largest cap asked for, and zero only disables it when nothing else
+     * has asked for any. */
+    size_t TintCacheSize = 32 << 20;
+
     bool SkipRenderingCreatures : 1;
     bool SkipRenderingItems : 1;
 
@@ -63,6 +74,80 @@ struct Options {
 
     bool SkipRenderingInventory : 1;
     bool SkipRenderingIconBar : 1;
+
+    bool operator==(const Options &other) const = default;
+};
+
+/* Common sets of options, that the renderer has been specialized for at
+ * compile time. When the flags of the options passed to DrawGamestate or
+ * DrawOverlay match those of a preset (regardless of resolution and tint
+ * cache size), they go through code where the flags are constants. Other
+ * options are tested as usual, which is what `Custom` stands for. */
+enum class Preset { Custom, Default, MapOnly, NoText, Minimap };
+
+/* Returns the preset matching the flags of `options`, or Preset::Custom. */
+Preset GetPreset(const Options &options) noexcept;
+
+/* Sets the flags of `options` to those of `preset`, leaving the resolution
+ * and tint cache size as-is. */
+void ApplyPreset(Preset preset, Options &options) noexcept;
+
+/* The static content of a floor, that is everything but creatures, effects,
+ * and missiles, drawn onto a transparent canvas with a margin of one tile
+ * around the game view so that it can be reused while the player walks. */
+struct FloorLayer {
+    /* Position of the player and the map revision as of when the layer was
+     * last drawn. */
+    trc::Position Position;
+    uint32_t Revision = 0;
+    int Floor = 0;
+    bool Valid = false;
+
+    std::unique_ptr<Canvas> Image;
+
+    /* How much of each 32x32 cell of the image is covered, letting empty
+     * parts of the floor be skipped when compositing. */
+    std::vector<Sprite::Coverage> Coverage;
+};
+
+/* Remembers what DrawGamestate last drew into a canvas, letting it redraw only
+ * the parts of the game view that have changed since: tiles that have been
+ * touched (see Map::Touch), and the surroundings of creatures, effects,
+ * missiles, and animated items.
+ *
+ * A state must only be used with one gamestate and one canvas, whose contents
+ * must be left alone between frames. Moving the view or changing the options
+ * forces a full redraw, which composites the cached static layer of each
+ * floor and only draws tiles with tick-driven content from scratch. */
+struct ViewState {
+    const trc::Map *Map = nullptr;
+    const uint8_t *Buffer = nullptr;
+    int Width = 0;
+    int Height = 0;
+
+    Renderer::Options Options = {};
+    trc::Position Position;
+    int ViewOffsetX = 0;
+    int ViewOffsetY = 0;
+    int TopFloor = 0;
+    int BottomFloor = 0;
+
+    /* Map revision as of the last frame. */
+    uint32_t Revision = 0;
+
+    /* 32x32 cells of the canvas that held tick-driven content last frame,
+     * which has to be erased even if nothing is there now. */
+    std::vector<bool> Volatile;
+
+    /* Indexed by floor modulo the map depth, see FloorLayer. */
+    std::array<FloorLayer, Map::TileBufferDepth> Layers;
+
+    /* Sized like the canvas and the floor layers, respectively. */
+    std::unique_ptr<Canvas> Scratch;
+    std::unique_ptr<Canvas> LayerScratch;
+
+    /* Draws of the current frame, rasterized on several threads at once. */
+    DisplayList List;
 };
 
 /* FIXME: C++ migration, `noexcept` specifiers are there as a shorthand to
@@ -119,14 +204,58 @@ void DrawClientBackground(Gamestate &gamestate,
                           int rightX,
                           int rightY) noexcept;
 
+/* What the interface looked like when it was last drawn, see
+ * UpdateInterfaceState. */
+struct InterfaceState {
+    uint32_t Generation = 0;
+    bool Drawn = false;
+};
+
+/* Returns whether anything drawn by the interface functions above may have
+ * changed since the last call with `state`, in which case the interface needs
+ * to be redrawn, updating `state` to match. This always holds while the
+ * player carries or looks at animated items. */
+bool UpdateInterfaceState(Gamestate &gamestate, InterfaceState &state) noexcept;
+
 /* ************************************************************************* */
 
 void DrawGamestate(const Options &options,
                    Gamestate &gamestate,
                    Canvas &canvas) noexcept;
 
+/* As above, but only redraws what has changed since the last frame drawn
+ * with `state`, leaving the rest of `canvas` as-is. Unlike the above this
+ * clears the background by itself. */
+void DrawGamestate(const Options &options,
+                   Gamestate &gamestate,
+                   ViewState &state,
+                   Canvas &canvas) noexcept;
+
+void DrawOverlay(const Options &options,
+                 Gamestate &gamestate,
+                 Canvas &canvas) noexcept;
+
+/* As above, but draws text through `texts`, pruning it with the generation of
+ * the message list. */
+void DrawOverlay(const Options &options,
+                 Gamestate &gamestate,
+                 TextRenderer::Cache &texts,
+                 Canvas &canvas) noexcept;
+
+/* As the above two, but going through the specialization for `P` regardless
+ * of what the flags of `options` match. These are mainly useful for
+ * benchmarking, as the plain versions pick the specialization by themselves.
+ * Unless `P` is Preset::Custom, the flags of `options` must match it. */
+template <Preset P>
+void DrawGamestate(const Options &options,
+                   Gamestate &gamestate,
+                   ViewState &state,
+                   Canvas &canvas) noexcept;
+
+template <Preset P>
 void DrawOverlay(const Options &options,
                  Gamestate &gamestate,
+                 TextRenderer::Cache &texts,
                  Canvas &canvas) noexcept;
 
 void DumpItem(Version &version, uint16_t item, Canvas &canvas) noexcept;
@@ -25,10 +25,79 @@
 
 #include "utils.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <new>
 #include <tuple>
 
+#ifndef DISABLE_THREADS
+#    include <thread>
+#endif
+
+#ifndef LEVEL1_DCACHE_LINESIZE
+#    error "LEVEL1_DCACHE_LINESIZE must be #defined"
+#endif
+
 namespace trc {
 
+void SpriteArena::ChunkDeleter::operator()(uint8_t *chunk) const {
+    ::operator delete[](chunk, std::align_val_t(LEVEL1_DCACHE_LINESIZE));
+}
+
+SpriteArena::SpriteArena() : Used(ChunkSize) {
+}
+
+void *SpriteArena::Allocate(size_t size, size_t alignment) {
+    AbortUnless(alignment > 0 && alignment <= LEVEL1_DCACHE_LINESIZE &&
+                (alignment & (alignment - 1)) == 0);
+    std::lock_guard<std::mutex> guard(Lock);
+
+    /* Chunks are cache-line aligned, so aligning the offset suffices. */
+    size_t offset = (Used + (alignment - 1)) & ~(alignment - 1);
+
+    if (size > ChunkSize) {
+        /* Oversized allocations get a chunk of their own, inserted before the
+         * current one so that we can keep bumping from the latter. */
+        auto chunk = static_cast<uint8_t *>(::operator new[](
+                size,
+                std::align_val_t(LEVEL1_DCACHE_LINESIZE)));
+        Chunks.emplace(Chunks.empty() ? Chunks.end() : Chunks.end() - 1,
+                       chunk);
+        return chunk;
+    } else if (offset + size > ChunkSize) {
+        auto chunk = static_cast<uint8_t *>(::operator new[](
+                ChunkSize,
+                std::align_val_t(LEVEL1_DCACHE_LINESIZE)));
+        Chunks.emplace_back(chunk);
+        offset = 0;
+    }
+
+    Used = offset + size;
+    return &Chunks.back()[offset];
+}
+
+/* The decoded pixels are immediately followed by their row spans. */
+static_assert(sizeof(Pixel) % alignof(Sprite::RowSpan) == 0);
+
+static Pixel *AllocateDecoded(SpriteArena *arena, size_t count, size_t rows) {
+    const size_t size = count * sizeof(Pixel) + rows * sizeof(Sprite::RowSpan);
+
+    if (arena != nullptr) {
+        return static_cast<Pixel *>(
+                arena->Allocate(size, LEVEL1_DCACHE_LINESIZE));
+    }
+
+    return static_cast<Pixel *>(
+            ::operator new[](size, std::align_val_t(LEVEL1_DCACHE_LINESIZE)));
+}
+
+static void DeallocateDecoded(SpriteArena *arena, Pixel *pixels) {
+    /* Arena memory is released together with the arena. */
+    if (arena == nullptr) {
+        ::operator delete[](pixels, std::align_val_t(LEVEL1_DCACHE_LINESIZE));
+    }
+}
+
 static std::tuple<size_t, size_t, size_t, size_t> MeasureSpriteBounds(
         const Canvas &canvas,
         ptrdiff_t x,
@@ -170,8 +239,9 @@ static size_t ExtractSprite(const Canvas &canvas,
 
 static std::pair<size_t, uint8_t *> ReadSprite(size_t width,
                                                size_t height,
-                                               DataReader &reader) {
-    size_t consumed = 0, required = 0;
+                                               DataReader &reader,
+                                               SpriteArena *arena) {
+    size_t consumed = 0, required = 0, opaqueTotal = 0;
 
     auto validator = reader;
 
@@ -187,13 +257,21 @@ static std::pair<size_t, uint8_t *> ReadSprite(size_t width,
 
         validator.Skip(opaque * 3);
         required += opaque * 4;
+        opaqueTotal += opaque;
     }
 
     if (consumed > width * height) {
         throw InvalidDataError();
     }
 
-    auto converted = new uint8_t[required];
+    if (opaqueTotal == 0) {
+        /* Fully transparent, treat it as empty so it's never decoded. */
+        return std::make_pair(0, nullptr);
+    }
+
+    auto converted =
+            arena ? static_cast<uint8_t *>(arena->Allocate(required, 1))
+                  : new uint8_t[required];
 
     for (size_t i = 0; reader.Remaining() > 0;) {
         uint16_t transparent;
@@ -228,7 +306,11 @@ Sprite::Sprite(const Canvas &canvas,
                size_t y,
                size_t width,
                size_t height,
-               Trim trim) {
+               Trim trim)
+    : Source(0, nullptr),
+      Arena(nullptr),
+      Decoded(nullptr),
+      Covered(Coverage::Empty) {
     auto [leftX, topY, rightX, bottomY] =
             MeasureSpriteBounds(canvas, x, y, width, height, trim);
 
@@ -260,17 +342,48 @@ Sprite::Sprite(const Canvas &canvas,
     Size = 0;
 }
 
-Sprite::Sprite(DataReader &data, size_t width, size_t height)
-    : Width(width), Height(height) {
+Sprite::Sprite(DataReader &data,
+               size_t width,
+               size_t height,
+               SpriteArena *arena)
+    : Width(width),
+      Height(height),
+      Source(0, nullptr),
+      Arena(arena),
+      Decoded(nullptr),
+      Covered(Coverage::Empty) {
     try {
-        std::tie(Size, Buffer) = ReadSprite(width, height, data);
+        std::tie(Size, Buffer) = ReadSprite(width, height, data, arena);
     } catch ([[maybe_unused]] const InvalidDataError &err) {
         Buffer = nullptr;
         Size = 0;
     }
 }
 
-Sprite::Sprite() : Width(0), Height(0), Size(0), Buffer(nullptr) {
+Sprite::Sprite(const DataReader &entry,
+               size_t width,
+               size_t height,
+               Deferred,
+               SpriteArena *arena)
+    : Width(width),
+      Height(height),
+      Size(0),
+      Buffer(nullptr),
+      Source(entry),
+      Arena(arena),
+      Decoded(nullptr),
+      Covered(Coverage::Empty) {
+}
+
+Sprite::Sprite()
+    : Width(0),
+      Height(0),
+      Size(0),
+      Buffer(nullptr),
+      Source(0, nullptr),
+      Arena(nullptr),
+      Decoded(nullptr),
+      Covered(Coverage::Empty) {
     /* Null sprite: valid but simply won't be drawn. */
 }
 
@@ -280,38 +393,171 @@ Sprite &Sprite::operator=(Sprite &&other) {
     Size = other.Size;
 
     std::swap(Buffer, other.Buffer);
+    std::swap(Source, other.Source);
+    std::swap(Arena, other.Arena);
+    other.Decoded.store(Decoded.exchange(other.Decoded.load()));
+    other.Covered.store(Covered.exchange(other.Covered.load()));
 
     return *this;
 }
 
 Sprite::~Sprite() {
-    if (Buffer != nullptr) {
+    if (Buffer != nullptr && Arena == nullptr) {
         delete[] Buffer;
     }
+
+    if (Pixel *pixels = Decoded.load()) {
+        DeallocateDecoded(Arena, pixels);
+    }
 }
 
-SpriteFile::SpriteFile(const VersionBase &version, DataReader data)
-    : Signature(data.ReadU32()) {
-    uint32_t count;
+/* Widens the row spans covered by the opaque run at `pixelIdx`. */
+static void AddOpaqueRun(Sprite::RowSpan *spans,
+                         size_t width,
+                         size_t pixelIdx,
+                         size_t count) {
+    while (count > 0) {
+        const size_t rowIdx = pixelIdx / width;
+        const size_t begin = pixelIdx % width;
+        const size_t end = std::min(width, begin + count);
+        Sprite::RowSpan &span = spans[rowIdx];
+
+        if (span.Begin == span.End) {
+            span.Begin = begin;
+            span.End = end;
+        } else {
+            span.Begin = std::min<size_t>(span.Begin, begin);
+            span.End = std::max<size_t>(span.End, end);
+        }
 
-    if (version.Features.SpriteIndexU32) {
-        /* To avoid running out of memory on version mismatches, we'll set a
-         * reasonably-high upper bound to error out quicker. */
-        count = data.ReadU32<1, 1 << 20u>();
+        pixelIdx += end - begin;
+        count -= end - begin;
+    }
+}
+
+/* Decodes a sprite file entry directly into `pixels`, skipping the
+ * intermediate run-length encoded form used by eagerly loaded sprites.
+ * Returns the number of opaque pixels. */
+static size_t DecodeEntry(DataReader entry,
+                          size_t width,
+                          size_t height,
+                          Pixel *pixels,
+                          Sprite::RowSpan *spans) {
+    const size_t count = width * height;
+
+    /* Color key */
+    entry.Skip(3);
+
+    auto reader = entry.Slice(entry.ReadU16());
+    size_t opaqueTotal = 0;
+
+    for (size_t pixelIdx = 0; reader.Remaining() > 0;) {
+        pixelIdx += reader.ReadU16();
+        size_t opaqueCount = reader.ReadU16();
+
+        if ((pixelIdx + opaqueCount) > count ||
+            reader.Remaining() < (opaqueCount * 3)) {
+            throw InvalidDataError();
+        }
+
+        const uint8_t *data = reader.RawData();
+        for (size_t idx = 0; idx < opaqueCount; idx++) {
+            pixels[pixelIdx + idx] = Pixel(data[idx * 3 + 0],
+                                           data[idx * 3 + 1],
+                                           data[idx * 3 + 2]);
+        }
+
+        AddOpaqueRun(spans, width, pixelIdx, opaqueCount);
+
+        reader.Skip(opaqueCount * 3);
+        pixelIdx += opaqueCount;
+        opaqueTotal += opaqueCount;
+    }
+
+    return opaqueTotal;
+}
+
+Pixel *Sprite::Decode() const {
+    const size_t count = Width * Height;
+    const size_t size = count * sizeof(Pixel) + Height * sizeof(RowSpan);
+    Pixel *pixels = AllocateDecoded(Arena, count, Height);
+    RowSpan *spans = reinterpret_cast<RowSpan *>(pixels + count);
+
+    size_t opaqueTotal = 0;
+
+    /* Zeroes both pixels and spans, making the latter empty. */
+    std::memset((void *)pixels, 0, size);
+
+    if (Source) {
+        try {
+            opaqueTotal = DecodeEntry(Source, Width, Height, pixels, spans);
+        } catch ([[maybe_unused]] const InvalidDataError &err) {
+            /* Ignore failures by leaving the sprite transparent: it's
+             * pretty common for sprite files out in the wild to be subtly
+             * corrupt. */
+            std::memset((void *)pixels, 0, size);
+            opaqueTotal = 0;
+        }
+    }
+
+    for (size_t byteIdx = 0, pixelIdx = 0; byteIdx < Size;) {
+        size_t opaqueCount;
+
+        pixelIdx += ((uint16_t)Buffer[byteIdx + 0] << 0x00) |
+                    ((uint16_t)Buffer[byteIdx + 1] << 0x08);
+        byteIdx += 2;
+
+        opaqueCount = ((uint16_t)Buffer[byteIdx + 0] << 0x00) |
+                      ((uint16_t)Buffer[byteIdx + 1] << 0x08);
+        byteIdx += 2;
+
+        /* Both ReadSprite and ExtractSprite guarantee this. */
+        AbortUnless((pixelIdx + opaqueCount) <= count &&
+                    (byteIdx + opaqueCount * sizeof(Pixel)) <= Size);
+
+        std::memcpy((void *)&pixels[pixelIdx],
+                    &Buffer[byteIdx],
+                    opaqueCount * sizeof(Pixel));
+        AddOpaqueRun(spans, Width, pixelIdx, opaqueCount);
+
+        byteIdx += opaqueCount * sizeof(Pixel);
+        pixelIdx += opaqueCount;
+        opaqueTotal += opaqueCount;
+    }
+
+    /* Published together with the pixels below, racing threads will store
+     * the same value. */
+    if (opaqueTotal == 0) {
+        Covered.store(Coverage::Empty, std::memory_order_relaxed);
+    } else if (opaqueTotal == count) {
+        Covered.store(Coverage::Opaque, std::memory_order_relaxed);
     } else {
-        count = data.ReadU16();
+        Covered.store(Coverage::Masked, std::memory_order_relaxed);
     }
 
-    auto indexEnd = data.Tell() + count * sizeof(uint32_t);
+    /* Several threads may race to decode the same sprite, let the first one
+     * win and discard the others. Losing arena allocations are simply left
+     * unused as this is rare. */
+    Pixel *expected = nullptr;
+    if (!Decoded.compare_exchange_strong(expected,
+                                         pixels,
+                                         std::memory_order_acq_rel)) {
+        DeallocateDecoded(Arena, pixels);
+        return expected;
+    }
 
-    /* The empty sprite 0 is not stored in the file per se but is nevertheless
-     * considered present; add it and bump ids by 1. */
-    (void)Sprites.emplace(std::piecewise_construct,
-                          std::forward_as_tuple(0),
-                          std::forward_as_tuple());
+    return pixels;
+}
 
-    for (uint32_t id = 1; id <= count; id++) {
-        auto spriteOffset = data.ReadU32();
+void SpriteFile::LoadRange(DataReader data,
+                           DataReader index,
+                           size_t indexEnd,
+                           uint32_t firstId,
+                           uint32_t lastId,
+                           bool deferred,
+                           SpriteArena &arena) {
+    for (uint32_t id = firstId; id <= lastId; id++) {
+        auto spriteOffset = index.ReadU32();
 
         if (spriteOffset < indexEnd) {
             /* Ignore failures: it's pretty common for sprite files out in the
@@ -323,16 +569,108 @@ SpriteFile::SpriteFile(const VersionBase &version, DataReader data)
         try {
             auto spriteReader = data.Seek(spriteOffset);
 
+            if (deferred) {
+                /* Skip sprites without any data up-front, as they would
+                 * otherwise be decoded into blank pixels when drawn. */
+                auto header = spriteReader;
+                header.Skip(3);
+
+                if (header.ReadU16() == 0) {
+                    continue;
+                }
+
+                Sprites[id] = Sprite(spriteReader,
+                                     32,
+                                     32,
+                                     Sprite::Deferred(),
+                                     &arena);
+                continue;
+            }
+
             /* color key */
             spriteReader.Skip(3);
 
+            /* As we're going through the sprites in order, their run-length
+             * encoded data will be laid out in the arena by id. */
             auto spriteData = spriteReader.Slice(spriteReader.ReadU16());
-            (void)Sprites.emplace(std::piecewise_construct,
-                                  std::forward_as_tuple(id),
-                                  std::forward_as_tuple(spriteData, 32, 32));
+            Sprites[id] = Sprite(spriteData, 32, 32, &arena);
         } catch ([[maybe_unused]] const InvalidDataError &err) {
         }
     }
 }
 
+/* Returns the number of ranges to split loading into. */
+static uint32_t CountLoadingRanges([[maybe_unused]] uint32_t count) {
+#ifdef DISABLE_THREADS
+    return 1;
+#else
+    /* Small files aren't worth splitting up. */
+    const uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    return std::clamp(count / 4096u, 1u, hardware);
+#endif
+}
+
+SpriteFile::SpriteFile(const VersionBase &version,
+                       DataReader data,
+                       bool deferred)
+    : Signature(data.ReadU32()) {
+    uint32_t count;
+
+    if (version.Features.SpriteIndexU32) {
+        /* To avoid running out of memory on version mismatches, we'll set a
+         * reasonably-high upper bound to error out quicker. */
+        count = data.ReadU32<1, 1 << 20u>();
+    } else {
+        count = data.ReadU16();
+    }
+
+    const size_t indexStart = data.Tell();
+    const size_t indexEnd = indexStart + count * sizeof(uint32_t);
+
+    /* Make sure the whole index is present before we start. */
+    (void)data.Slice(count * sizeof(uint32_t));
+
+    /* The empty sprite 0 is not stored in the file per se but is nevertheless
+     * considered present, so we'll index by id directly and leave slot 0
+     * empty, as well as any sprites we fail to load.
+     *
+     * Note that this table is never resized past this point, as types refer
+     * to sprites by address. */
+    Sprites = std::vector<Sprite>(count + 1);
+
+    const uint32_t ranges = CountLoadingRanges(count);
+
+    for (uint32_t range = 0; range < ranges; range++) {
+        const uint32_t firstId = 1 + (uint64_t)count * range / ranges;
+        const uint32_t lastId = (uint64_t)count * (range + 1) / ranges;
+        auto index = data.Seek(indexStart + (firstId - 1) * sizeof(uint32_t));
+        auto &arena = Arenas.emplace_back();
+
+#ifdef DISABLE_THREADS
+        LoadRange(data, index, indexEnd, firstId, lastId, deferred, arena);
+#else
+        Pending.emplace_back(
+                std::async(std::launch::async, [=, this, &arena]() {
+                    LoadRange(data,
+                              index,
+                              indexEnd,
+                              firstId,
+                              lastId,
+                              deferred,
+                              arena);
+                }));
+#endif
+    }
+}
+
+void SpriteFile::Wait() {
+#ifndef DISABLE_THREADS
+    for (auto &pending : Pending) {
+        pending.get();
+    }
+
+    Pending.clear();
+#endif
+}
+
 } // namespace trc
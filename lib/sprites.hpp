@@ -21,10 +21,19 @@
 #ifndef __TRC_SPRITES_HPP__
 #define __TRC_SPRITES_HPP__
 
+#include <atomic>
 #include <cstdint>
-#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef DISABLE_THREADS
+#    include <future>
+#endif
 
 #include "datareader.hpp"
+#include "pixel.hpp"
 #include "versions_decl.hpp"
 
 namespace trc {
@@ -32,6 +41,27 @@ namespace trc {
 /* Forward-declare Canvas to break a circular dependency. */
 class Canvas;
 
+/* Bump allocator for sprite data, which is released all at once together
+ * with the arena. This keeps the data of a sprite file in a few large chunks
+ * rather than tens of thousands of small heap allocations. Thread-safe. */
+class SpriteArena {
+    struct ChunkDeleter {
+        void operator()(uint8_t *chunk) const;
+    };
+
+    std::mutex Lock;
+    std::vector<std::unique_ptr<uint8_t[], ChunkDeleter>> Chunks;
+    size_t Used;
+
+public:
+    static constexpr size_t ChunkSize = 1 << 20;
+
+    void *Allocate(size_t size, size_t alignment);
+
+    SpriteArena();
+    SpriteArena(const SpriteArena &other) = delete;
+};
+
 struct Sprite {
     int Width;
     int Height;
@@ -40,6 +70,20 @@ struct Sprite {
 
     enum class Trim { None, Right };
 
+    /* Tag for deferred loading, see below. */
+    struct Deferred {};
+
+    /* How much of the sprite is covered by opaque pixels, letting callers
+     * skip empty sprites and draw fully opaque ones without masking. */
+    enum class Coverage : uint8_t { Empty, Opaque, Masked };
+
+    /* Horizontal extent of the opaque pixels in a row, `Begin == End` if the
+     * row is fully transparent. */
+    struct RowSpan {
+        uint16_t Begin;
+        uint16_t End;
+    };
+
     /** @brief Extracts a sprite from the given canvas */
     Sprite(const Canvas &canvas,
            size_t x,
@@ -48,8 +92,23 @@ struct Sprite {
            size_t height,
            Trim trim = Trim::None);
 
-    /** @brief Loads a sprite from the given data stream */
-    Sprite(DataReader &data, size_t width, size_t height);
+    /** @brief Loads a sprite from the given data stream, allocating from
+     * `arena` if given. */
+    Sprite(DataReader &data,
+           size_t width,
+           size_t height,
+           SpriteArena *arena = nullptr);
+
+    /** @brief Refers to a sprite file entry (color key, length, and data)
+     * without reading it.
+     *
+     * The entry is decoded on first use, so the underlying data must outlive
+     * the sprite. Corrupt entries are treated as fully transparent. */
+    Sprite(const DataReader &entry,
+           size_t width,
+           size_t height,
+           Deferred,
+           SpriteArena *arena = nullptr);
 
     Sprite &operator=(Sprite &&other);
 
@@ -57,21 +116,79 @@ struct Sprite {
     ~Sprite();
 
     Sprite(const Sprite &) = delete;
-};
 
-struct SpriteFile {
-    std::unordered_map<uint32_t, Sprite> Sprites;
+    /** @brief Returns a dense Width x Height copy of the sprite, where
+     * transparent pixels are zeroed out.
+     *
+     * This is decoded on first use and then kept alongside the run-length
+     * encoded data, as most sprites in a data file are never drawn. Returns
+     * nullptr for empty sprites. */
+    const Pixel *Pixels() const {
+        Pixel *pixels = Decoded.load(std::memory_order_acquire);
+
+        if (pixels == nullptr && (Size > 0 || Source)) {
+            pixels = Decode();
+        }
+
+        return pixels;
+    }
+
+    /** @brief Returns the opaque extent of each row in Pixels(), letting
+     * clipped draws skip transparent margins without scanning for them.
+     *
+     * Returns nullptr for empty sprites. */
+    const RowSpan *Spans() const {
+        const Pixel *pixels = Pixels();
+
+        if (pixels == nullptr) {
+            return nullptr;
+        }
+
+        return reinterpret_cast<const RowSpan *>(pixels + Width * Height);
+    }
+
+    /** @brief Classifies the sprite, decoding it if needed. */
+    Coverage GetCoverage() const {
+        if (Pixels() == nullptr) {
+            return Coverage::Empty;
+        }
 
+        /* Ordered by the acquire in Pixels(). */
+        return Covered.load(std::memory_order_relaxed);
+    }
+
+private:
+    /* Sprite file entry for deferred sprites, empty otherwise. */
+    DataReader Source;
+    /* Owner of `Buffer` and `Decoded` if set, the heap otherwise. */
+    SpriteArena *Arena;
+    mutable std::atomic<Pixel *> Decoded;
+    mutable std::atomic<Coverage> Covered;
+
+    Pixel *Decode() const;
+};
+
+class SpriteFile {
 public:
     const uint32_t Signature;
 
-    SpriteFile(const VersionBase &version, DataReader data);
+    /* When `deferred` is true, only the index is read up-front and sprites
+     * are decoded as they're drawn. The caller must then keep `data` alive
+     * for as long as the sprite file.
+     *
+     * Sprites are loaded in the background, split into ranges by id, and the
+     * sprite file must not be used until Wait() has returned. The addresses
+     * of sprites are however known up-front, letting type data be parsed in
+     * the meantime. */
+    SpriteFile(const VersionBase &version, DataReader data, bool deferred);
 
-    const Sprite &Get(uint32_t index) const {
-        auto it = Sprites.find(index);
+    /* Waits for all sprites to load, rethrowing any error raised while
+     * loading them. */
+    void Wait();
 
-        if (it != Sprites.end()) {
-            return it->second;
+    const Sprite &Get(uint32_t index) const {
+        if (index < Sprites.size()) {
+            return Sprites[index];
         }
 
         /* Ignore failures by returning a dummy sprite that won't be drawn:
@@ -82,6 +199,27 @@ public:
     }
 
     SpriteFile(const SpriteFile &other) = delete;
+
+private:
+    /* One per loading range so that loaders don't contend on allocation. */
+    std::deque<SpriteArena> Arenas;
+
+    /* Indexed by sprite id, where missing sprites are left empty. */
+    std::vector<Sprite> Sprites;
+
+#ifndef DISABLE_THREADS
+    /* Ranges still loading in the background, declared after `Sprites` so
+     * that they finish before the table is destroyed. */
+    std::vector<std::future<void>> Pending;
+#endif
+
+    void LoadRange(DataReader data,
+                   DataReader index,
+                   size_t indexEnd,
+                   uint32_t firstId,
+                   uint32_t lastId,
+                   bool deferred,
+                   SpriteArena &arena);
 };
 
 } // namespace trc
@@ -289,6 +289,185 @@ void Render(const Font &font,
     } while (lineStart < text.size());
 }
 
+/* Keeps centered text from being clamped to the left edge of the image it's
+ * rendered into, see Render. */
+static constexpr int CachePadding = 2;
+
+const Cache::Entry *Cache::Get(const Font &font,
+                               const TextAlignment alignment,
+                               const TextTransform transform,
+                               const Pixel &color,
+                               const size_t lineMaxLength,
+                               const std::string &text) {
+    /* The alpha of the color replaces that of the glyphs, so unless it's
+     * opaque, the pre-rendered text would not blit as it's drawn. */
+    if (text.size() == 0 || color.Alpha != 0xFF) {
+        return nullptr;
+    }
+
+    const Font *fontAddress = &font;
+
+    Key.assign((const char *)&fontAddress, sizeof(fontAddress));
+    Key.push_back((char)alignment);
+    Key.push_back((char)transform);
+    Key.append((const char *)&color, sizeof(color));
+    Key.append((const char *)&lineMaxLength, sizeof(lineMaxLength));
+    Key.append(text);
+
+    auto it = Entries.find(Key);
+
+    if (it != Entries.end()) {
+        it->second.Generation = Generation;
+        return &it->second;
+    }
+
+    const auto bounds = TextRenderer::MeasureBounds(font,
+                                                    transform,
+                                                    lineMaxLength,
+                                                    text);
+
+    int anchor = 0;
+
+    switch (alignment) {
+    case TextAlignment::Left:
+        anchor = 0;
+        break;
+    case TextAlignment::Center:
+        anchor = bounds.first / 2;
+        break;
+    case TextAlignment::Right:
+        anchor = bounds.first;
+        break;
+    }
+
+    /* Glyphs may be wider than the distance to the next one, leave some room
+     * for that and trim it afterwards. */
+    auto image = std::make_unique<Canvas>(CachePadding + bounds.first + 32,
+                                          bounds.second);
+    const size_t size = image->Stride * image->Height + Key.size();
+
+    if (Used + size > MemoryLimit) {
+        std::erase_if(Entries, [this](const auto &item) {
+            if (item.second.Generation != Generation) {
+                Used -= item.second.Size;
+                return true;
+            }
+
+            return false;
+        });
+
+        if (Used + size > MemoryLimit) {
+            return nullptr;
+        }
+    }
+
+    image->Wipe();
+    TextRenderer::Render(font,
+                         alignment,
+                         transform,
+                         color,
+                         CachePadding + anchor,
+                         0,
+                         lineMaxLength,
+                         text,
+                         *image);
+
+    int width = CachePadding;
+
+    for (int y = 0; y < image->Height; y++) {
+        for (int x = image->Width - 1; x >= width; x--) {
+            if (!image->GetPixel(x, y).IsTransparent()) {
+                width = x + 1;
+                break;
+            }
+        }
+    }
+
+    Used += size;
+
+    return &Entries
+                    .emplace(Key,
+                             Entry{.Image = std::move(image),
+                                   .Bounds = bounds,
+                                   .Anchor = anchor,
+                                   .Width = width,
+                                   .Size = size,
+                                   .Generation = Generation})
+                    .first->second;
+}
+
+std::pair<size_t, size_t> Cache::MeasureBounds(const Font &font,
+                                               const TextAlignment alignment,
+                                               const TextTransform transform,
+                                               const Pixel &color,
+                                               const size_t lineMaxLength,
+                                               const std::string &text) {
+    if (auto entry =
+                Get(font, alignment, transform, color, lineMaxLength, text)) {
+        return entry->Bounds;
+    }
+
+    return TextRenderer::MeasureBounds(font, transform, lineMaxLength, text);
+}
+
+void Cache::Render(const Font &font,
+                   const TextAlignment alignment,
+                   const TextTransform transform,
+                   const Pixel &color,
+                   const int X,
+                   const int Y,
+                   const size_t lineMaxLength,
+                   const std::string &text,
+                   Canvas &canvas) {
+    auto entry = Get(font, alignment, transform, color, lineMaxLength, text);
+
+    /* Centered lines that would reach past the left edge of the canvas are
+     * clamped to it one by one, so we'll have to draw those as-is. */
+    if (entry == nullptr || (alignment == TextAlignment::Center &&
+                             X - entry->Anchor < CachePadding)) {
+        TextRenderer::Render(font,
+                             alignment,
+                             transform,
+                             color,
+                             X,
+                             Y,
+                             lineMaxLength,
+                             text,
+                             canvas);
+        return;
+    }
+
+    canvas.Composite(*entry->Image,
+                     CachePadding,
+                     0,
+                     X - entry->Anchor,
+                     Y,
+                     entry->Width - CachePadding,
+                     entry->Image->Height);
+}
+
+void Cache::Prune(uint32_t generation) {
+    if (generation == Generation) {
+        return;
+    }
+
+    Generation = generation;
+
+    std::erase_if(Entries, [this](const auto &item) {
+        if (Generation - item.second.Generation > MaxAge) {
+            Used -= item.second.Size;
+            return true;
+        }
+
+        return false;
+    });
+}
+
+void Cache::Clear() {
+    Entries.clear();
+    Used = 0;
+}
+
 } // namespace TextRenderer
 
 } // namespace trc
\ No newline at end of file
@@ -23,6 +23,10 @@
 
 #include "fonts.hpp"
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 
 namespace trc {
@@ -47,6 +51,74 @@ void Render(const Font &font,
             const std::string &text,
             Canvas &canvas);
 
+/* Pre-rendered text, letting strings that are drawn over and over again, such
+ * as creature names and messages, be drawn with a single blit.
+ *
+ * Entries are keyed by everything that affects how the text looks, and are
+ * evicted by generation: Prune() is meant to be called with the generation of
+ * the message list the text is drawn for (see MessageList::Prune), dropping
+ * whatever has gone unused while messages were removed `MaxAge` times over,
+ * however many frames that took. Should the cache grow past `MemoryLimit`
+ * regardless, everything but the text used in the current generation is
+ * dropped, and text that still doesn't fit is drawn as-is.
+ *
+ * Fonts are referred to by address, so the cache must be cleared when they
+ * are replaced. */
+class Cache {
+    struct Entry {
+        std::unique_ptr<Canvas> Image;
+        std::pair<size_t, size_t> Bounds;
+        /* Horizontal distance from the left edge of the text to the X
+         * coordinate it's drawn at, as given by its alignment. */
+        int Anchor;
+        /* Width of the drawn pixels in `Image`, including padding. */
+        int Width;
+        /* Memory used by the entry, counted against `MemoryLimit`. */
+        size_t Size;
+        uint32_t Generation;
+    };
+
+    std::unordered_map<std::string, Entry> Entries;
+    /* Scratch space for building lookup keys. */
+    std::string Key;
+    size_t Used = 0;
+    uint32_t Generation = 0;
+
+    const Entry *Get(const Font &font,
+                     const TextAlignment alignment,
+                     const TextTransform transform,
+                     const Pixel &color,
+                     const size_t lineMaxLength,
+                     const std::string &text);
+
+public:
+    static constexpr size_t MemoryLimit = 8 << 20;
+    static constexpr uint32_t MaxAge = 32;
+
+    /* As the functions of the same names above, where MeasureBounds also
+     * takes the alignment and color of the text so that measuring and then
+     * drawing it only renders it once. */
+    std::pair<size_t, size_t> MeasureBounds(const Font &font,
+                                            const TextAlignment alignment,
+                                            const TextTransform transform,
+                                            const Pixel &color,
+                                            const size_t lineMaxLength,
+                                            const std::string &text);
+
+    void Render(const Font &font,
+                const TextAlignment alignment,
+                const TextTransform transform,
+                const Pixel &color,
+                int X,
+                int Y,
+                const size_t lineMaxLength,
+                const std::string &text,
+                Canvas &canvas);
+
+    void Prune(uint32_t generation);
+    void Clear();
+};
+
 /* Helper macros, calling Render directly all the time would get ugly. Add more
  * as necessary. */
 
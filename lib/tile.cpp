@@ -29,7 +29,7 @@ static int GetStackPriority(const Version &version, const Object &object) {
         return 4;
     }
 
-    return version.GetItem(object.Id).Properties.StackPriority;
+    return version.GetItem(object).Properties.StackPriority;
 }
 
 void Tile::Clear() {
@@ -38,6 +38,34 @@ void Tile::Clear() {
     GraphicalEffects = {};
     NumericalIndex = 0;
     NumericalEffects = {};
+
+    Unlookable = false;
+    BlocksPlayerVision = false;
+    UpdatesRenderHeight = false;
+}
+
+void Tile::UpdateFlags(const Version &version) {
+    Unlookable = false;
+    BlocksPlayerVision = false;
+    UpdatesRenderHeight = false;
+
+    for (int objectIdx = 0; objectIdx < ObjectCount; objectIdx++) {
+        const auto &object = Objects[objectIdx];
+
+        if (!object.IsCreature()) {
+            const auto &properties = version.GetItem(object).Properties;
+
+            Unlookable |= properties.Unlookable;
+
+            if (!properties.DontHide) {
+                /* Things with a stack priority of 0 (ground) and 2 (some
+                 * railings) count as solids and cannot be seen through. */
+                BlocksPlayerVision |= properties.StackPriority == 0 ||
+                                      properties.StackPriority == 2;
+                UpdatesRenderHeight |= properties.StackPriority == 0;
+            }
+        }
+    }
 }
 
 void Tile::AddGraphicalEffect(uint8_t effectId, uint32_t currentTick) {
@@ -94,6 +122,8 @@ void Tile::RemoveObject(const Version &version, uint8_t stackPosition) {
     }
 
     ObjectCount--;
+
+    UpdateFlags(version);
 }
 
 Object &Tile::GetObject(const Version &version, uint8_t stackPosition) {
@@ -130,6 +160,8 @@ void Tile::SetObject(const Version &version,
     }
 
     Objects[stackPosition] = object;
+
+    UpdateFlags(version);
 }
 
 void Tile::InsertObject(const Version &version,
@@ -162,6 +194,7 @@ void Tile::InsertObject(const Version &version,
                 Objects[stackIdx] = object;
                 ObjectCount++;
 
+                UpdateFlags(version);
                 return;
             }
         }
@@ -185,6 +218,8 @@ void Tile::InsertObject(const Version &version,
         Objects[stackPosition] = object;
         ObjectCount++;
     }
+
+    UpdateFlags(version);
 }
 
 } // namespace trc
\ No newline at end of file
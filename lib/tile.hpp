@@ -37,6 +37,14 @@ struct Tile {
     uint8_t ObjectCount = 0;
     uint8_t GraphicalIndex = 0;
 
+    /* Summaries of the items on the tile, sparing the renderer from looking
+     * through them every frame. These are kept up to date by the functions
+     * below, and direct changes to `Objects` must be followed by a call to
+     * UpdateFlags(). */
+    bool Unlookable : 1 = false;
+    bool BlocksPlayerVision : 1 = false;
+    bool UpdatesRenderHeight : 1 = false;
+
     uint8_t NumericalIndex = 0;
     std::array<NumericalEffect, MaxEffects> NumericalEffects;
 
@@ -58,6 +66,8 @@ struct Tile {
                    uint8_t stackPosition);
     void RemoveObject(const Version &version, uint8_t stackPosition);
 
+    void UpdateFlags(const Version &version);
+
     void Clear();
 };
 
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2025 "John Högberg"
+ *
+ * This file is part of tibiarc.
+ *
+ * tibiarc is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * tibiarc is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with tibiarc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tintcache.hpp"
+
+#include "canvas.hpp"
+
+#include "utils.hpp"
+
+#include <functional>
+
+namespace trc {
+
+static bool IsTintKey(const Pixel &pixel) {
+    if (pixel.IsTransparent()) {
+        return false;
+    }
+
+    return (pixel.Red == 0 && pixel.Green == 0 && pixel.Blue == 0xFF) ||
+           (pixel.Red == 0xFF && pixel.Green == 0xFF && pixel.Blue == 0) ||
+           (pixel.Red == 0 && pixel.Green == 0xFF && pixel.Blue == 0) ||
+           (pixel.Red == 0xFF && pixel.Green == 0 && pixel.Blue == 0);
+}
+
+static std::unique_ptr<const Sprite> CreateTinted(const Sprite &base,
+                                                  const Sprite &mask,
+                                                  int head,
+                                                  int primary,
+                                                  int secondary,
+                                                  int detail) {
+    const Pixel *basePixels = base.Pixels();
+    const Pixel *maskPixels = mask.Pixels();
+
+    if (maskPixels != nullptr) {
+        if (mask.Width != base.Width || mask.Height != base.Height) {
+            return nullptr;
+        }
+
+        for (int idx = 0; idx < mask.Width * mask.Height; idx++) {
+            if (IsTintKey(maskPixels[idx]) &&
+                (basePixels == nullptr || basePixels[idx].IsTransparent())) {
+                return nullptr;
+            }
+        }
+    }
+
+    /* Sprite extraction requires a margin past the bottom-right corner. */
+    Canvas canvas(base.Width + 1, base.Height + 1);
+
+    canvas.Wipe();
+    canvas.Draw(base, 0, 0, base.Width, base.Height);
+    canvas.Tint(mask,
+                0,
+                0,
+                base.Width,
+                base.Height,
+                head,
+                primary,
+                secondary,
+                detail);
+
+    return std::make_unique<const Sprite>(canvas,
+                                          0,
+                                          0,
+                                          base.Width,
+                                          base.Height);
+}
+
+size_t TintCache::KeyHash::operator()(const Key &key) const {
+    size_t hash = std::hash<const Sprite *>()(key.Base);
+
+    hash ^= std::hash<const Sprite *>()(key.Mask) + 0x9E3779B9 + (hash << 6) +
+            (hash >> 2);
+    hash ^= std::hash<uint32_t>()(key.Colors) + 0x9E3779B9 + (hash << 6) +
+            (hash >> 2);
+
+    return hash;
+}
+
+TintCache::TintCache()
+    : Capacity(0), Size(0), Hits(0), Misses(0), Evictions(0) {
+}
+
+size_t TintCache::MeasureEntry(const Entry &entry) {
+    size_t size = sizeof(Entry) + sizeof(Slot) + sizeof(Key);
+
+    if (entry.Tinted) {
+        size += sizeof(Sprite) + entry.Tinted->Size +
+                entry.Tinted->Width * entry.Tinted->Height * sizeof(Pixel) +
+                entry.Tinted->Height * sizeof(Sprite::RowSpan);
+    }
+
+    return size;
+}
+
+void TintCache::Evict(size_t target) {
+    while (Size > target && !Recency.empty()) {
+        auto &[key, entry] = Recency.back();
+
+        Size -= MeasureEntry(*entry);
+        Index.erase(key);
+        Recency.pop_back();
+
+        Evictions++;
+    }
+}
+
+std::shared_ptr<const TintCache::Entry> TintCache::Get(const Sprite &base,
+                                                       const Sprite &mask,
+                                                       int head,
+                                                       int primary,
+                                                       int secondary,
+                                                       int detail) {
+    Assert(CheckRange(head, 0, 0xFF) && CheckRange(primary, 0, 0xFF) &&
+           CheckRange(secondary, 0, 0xFF) && CheckRange(detail, 0, 0xFF));
+    const Key key{.Base = &base,
+                  .Mask = &mask,
+                  .Colors = ((uint32_t)head << 24) | ((uint32_t)primary << 16) |
+                            ((uint32_t)secondary << 8) | (uint32_t)detail};
+
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+
+        if (Capacity == 0) {
+            return nullptr;
+        }
+
+        auto it = Index.find(key);
+        if (it != Index.end()) {
+            Recency.splice(Recency.begin(), Recency, it->second);
+            Hits++;
+
+            return it->second->second;
+        }
+
+        Misses++;
+    }
+
+    /* Tint outside of the lock, racing threads will at worst do some
+     * redundant work. */
+    auto entry = std::make_shared<Entry>();
+    entry->Tinted =
+            CreateTinted(base, mask, head, primary, secondary, detail);
+
+    std::lock_guard<std::mutex> guard(Lock);
+    size_t entrySize = MeasureEntry(*entry);
+
+    if (entrySize <= Capacity && !Index.contains(key)) {
+        Evict(Capacity - entrySize);
+
+        Recency.emplace_front(key, entry);
+        Index.emplace(key, Recency.begin());
+        Size += entrySize;
+    }
+
+    return entry;
+}
+
+void TintCache::SetCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> guard(Lock);
+
+    Capacity = capacity;
+    Evict(Capacity);
+}
+
+void TintCache::Grow(size_t capacity) {
+    /* The cap is only changed with the lock held, so checking it without
+     * the lock at worst postpones growing it until the next call. */
+    if (Capacity.load(std::memory_order_relaxed) < capacity) {
+        std::lock_guard<std::mutex> guard(Lock);
+
+        if (Capacity < capacity) {
+            Capacity = capacity;
+        }
+    }
+}
+
+size_t TintCache::GetCapacity() const {
+    std::lock_guard<std::mutex> guard(Lock);
+    return Capacity;
+}
+
+TintCache::Statistics TintCache::GetStatistics() const {
+    std::lock_guard<std::mutex> guard(Lock);
+
+    return Statistics{.Hits = Hits,
+                      .Misses = Misses,
+                      .Evictions = Evictions,
+                      .Entries = Index.size(),
+                      .Size = Size};
+}
+
+} // namespace trc
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2025 "John Högberg"
+ *
+ * This file is part of tibiarc.
+ *
+ * tibiarc is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * tibiarc is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with tibiarc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TRC_TINTCACHE_HPP__
+#define __TRC_TINTCACHE_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "sprites.hpp"
+
+namespace trc {
+
+/* Bounded LRU cache of outfit sprites that have already been tinted, so that
+ * creatures whose outfits don't change can be drawn with a plain blit instead
+ * of a draw followed by a tint.
+ *
+ * This is shared between everything rendering against the same Version, and
+ * is therefore safe to use from several threads at once. */
+class TintCache {
+public:
+    struct Statistics {
+        uint64_t Hits;
+        uint64_t Misses;
+        uint64_t Evictions;
+        size_t Entries;
+        size_t Size;
+    };
+
+    struct Entry {
+        /* The base sprite with the tint applied, or nullptr if the tint mask
+         * covers transparent parts of the base sprite. The tint then applies
+         * to whatever lies beneath, so it cannot be cached and the caller has
+         * to draw and tint as usual. */
+        std::unique_ptr<const Sprite> Tinted;
+    };
+
+    /* Returns the tinted version of `base`, creating it if necessary, or
+     * nullptr if the cache is disabled. The returned entry stays valid even
+     * if it's evicted while in use. */
+    std::shared_ptr<const Entry> Get(const Sprite &base,
+                                     const Sprite &mask,
+                                     int head,
+                                     int primary,
+                                     int secondary,
+                                     int detail);
+
+    /* Sets the memory cap in bytes, evicting entries as needed. A capacity
+     * of zero disables the cache altogether. */
+    void SetCapacity(size_t capacity);
+
+    /* Raises the memory cap to `capacity` unless it's already at least that
+     * large. This is cheap enough to call on every frame as it only takes
+     * the lock when the cap actually changes, which it never does once
+     * everything sharing the cache has asked for what it wants. */
+    void Grow(size_t capacity);
+    size_t GetCapacity() const;
+
+    Statistics GetStatistics() const;
+
+    TintCache();
+    TintCache(const TintCache &other) = delete;
+
+private:
+    struct Key {
+        const Sprite *Base;
+        const Sprite *Mask;
+        uint32_t Colors;
+
+        bool operator==(const Key &other) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+
+    using Slot = std::pair<Key, std::shared_ptr<const Entry>>;
+
+    mutable std::mutex Lock;
+
+    /* Most recently used entries first. */
+    std::list<Slot> Recency;
+    std::unordered_map<Key, std::list<Slot>::iterator, KeyHash> Index;
+
+    std::atomic<size_t> Capacity;
+    size_t Size;
+
+    uint64_t Hits;
+    uint64_t Misses;
+    uint64_t Evictions;
+
+    static size_t MeasureEntry(const Entry &entry);
+    void Evict(size_t target);
+};
+
+} // namespace trc
+
+#endif /* __TRC_TINTCACHE_HPP__ */
@@ -26,8 +26,10 @@
 
 #include "utils.hpp"
 
-#include <utility>
+#include <algorithm>
+#include <initializer_list>
 #include <limits>
+#include <utility>
 
 namespace trc {
 
@@ -317,10 +319,12 @@ TypeFile::TypeCategory::TypeCategory(const Version &version,
                                      uint16_t maxId,
                                      bool hasFrameGroups)
     : MinId(minId), MaxId(maxId) {
+    if (maxId >= minId) {
+        Entities.reserve(maxId - minId + 1);
+    }
+
     for (auto idx = minId; idx <= maxId; idx++) {
-        Entities.emplace(std::piecewise_construct,
-                         std::forward_as_tuple(idx),
-                         std::forward_as_tuple(version, data, hasFrameGroups));
+        Entities.emplace_back(version, data, hasFrameGroups);
     }
 }
 
@@ -334,46 +338,24 @@ TypeFile::TypeFile(const Version &version, DataReader data)
       Outfits(version, data, 1, OutfitMaxId, version.Features.FrameGroups),
       Effects(version, data, 1, EffectMaxId, false),
       Missiles(version, data, 1, MissileMaxId, false) {
-}
-
-const EntityType &TypeFile::GetItem(uint16_t id) const {
-    auto it = Items.Entities.find(id);
-
-    if (it != Items.Entities.end()) {
-        return it->second;
-    }
-
-    throw InvalidDataError();
-}
-
-const EntityType &TypeFile::GetOutfit(uint16_t id) const {
-    auto it = Outfits.Entities.find(id);
-
-    if (it != Outfits.Entities.end()) {
-        return it->second;
-    }
-
-    throw InvalidDataError();
-}
-
-const EntityType &TypeFile::GetEffect(uint16_t id) const {
-    auto it = Effects.Entities.find(id);
-
-    if (it != Effects.Entities.end()) {
-        return it->second;
-    }
-
-    throw InvalidDataError();
-}
-
-const EntityType &TypeFile::GetMissile(uint16_t id) const {
-    auto it = Missiles.Entities.find(id);
-
-    if (it != Missiles.Entities.end()) {
-        return it->second;
+    MaxSize = 32;
+    MaxDisplacement = 0;
+
+    for (const auto *category : {&Items, &Outfits, &Effects, &Missiles}) {
+        for (const auto &type : category->Entities) {
+            MaxDisplacement = std::max<int>({MaxDisplacement,
+                                             type.Properties.DisplacementX,
+                                             type.Properties.DisplacementY});
+
+            for (const auto &frameGroup : type.FrameGroups) {
+                if (frameGroup.Active) {
+                    MaxSize = std::max<int>({MaxSize,
+                                             frameGroup.SizeX * 32,
+                                             frameGroup.SizeY * 32});
+                }
+            }
+        }
     }
-
-    throw InvalidDataError();
 }
 
 }; // namespace trc
@@ -28,6 +28,7 @@
 
 #include "sprites.hpp"
 #include "datareader.hpp"
+#include "utils.hpp"
 
 #include <vector>
 
@@ -191,6 +192,10 @@ public:
     EntityType(const Version &version, DataReader &data, bool hasFrameGroups);
 
     EntityType(const EntityType &other) = delete;
+
+    /* Only for the benefit of std::vector, types never move once loaded as
+     * objects refer to them, see Object::Type. */
+    EntityType(EntityType &&other) = default;
 };
 
 class TypeFile {
@@ -202,9 +207,16 @@ public:
     const uint16_t EffectMaxId;
     const uint16_t MissileMaxId;
 
+    /* The size in pixels of the largest type in any direction, and the
+     * largest displacement of any type, bounding how far from its tile an
+     * object can be drawn. */
+    int MaxSize;
+    int MaxDisplacement;
+
 private:
     struct TypeCategory {
-        std::unordered_map<uint32_t, EntityType> Entities;
+        /* Indexed by `id - MinId`. */
+        std::vector<EntityType> Entities;
 
         uint16_t MinId;
         uint16_t MaxId;
@@ -214,6 +226,14 @@ private:
                      uint16_t minId,
                      uint16_t maxId,
                      bool hasFrameGroups);
+
+        const EntityType &Get(uint16_t id) const {
+            if (id < MinId || id > MaxId) {
+                throw InvalidDataError();
+            }
+
+            return Entities[id - MinId];
+        }
     };
 
     struct TypeCategory Items;
@@ -222,10 +242,21 @@ private:
     struct TypeCategory Missiles;
 
 public:
-    const EntityType &GetItem(uint16_t id) const;
-    const EntityType &GetOutfit(uint16_t id) const;
-    const EntityType &GetEffect(uint16_t id) const;
-    const EntityType &GetMissile(uint16_t id) const;
+    const EntityType &GetItem(uint16_t id) const {
+        return Items.Get(id);
+    }
+
+    const EntityType &GetOutfit(uint16_t id) const {
+        return Outfits.Get(id);
+    }
+
+    const EntityType &GetEffect(uint16_t id) const {
+        return Effects.Get(id);
+    }
+
+    const EntityType &GetMissile(uint16_t id) const {
+        return Missiles.Get(id);
+    }
 
     /* FIXME: Currently needs sprites initialized, this is pretty bad coupling
      * there's not much we can do about it. */
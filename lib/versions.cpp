@@ -663,13 +663,18 @@ VersionBase::VersionBase(const VersionTriplet &triplet)
 Version::Version(const VersionTriplet &triplet,
                  const DataReader &pictureData,
                  const DataReader &spriteData,
-                 const DataReader &typeData)
+                 const DataReader &typeData,
+                 std::shared_ptr<const void> spriteBacking)
     : VersionBase(triplet),
+      SpriteBacking(std::move(spriteBacking)),
+      Sprites(static_cast<VersionBase &>(*this),
+              spriteData,
+              SpriteBacking != nullptr),
       Pictures(static_cast<VersionBase &>(*this), pictureData),
-      Sprites(static_cast<VersionBase &>(*this), spriteData),
       Types(*this, typeData),
       Icons(*this),
       Fonts(*this) {
+    Sprites.Wait();
 }
 
 } // namespace trc
\ No newline at end of file
@@ -28,11 +28,14 @@
 #include "fonts.hpp"
 #include "icons.hpp"
 #include "message.hpp"
+#include "object.hpp"
 #include "pictures.hpp"
+#include "tintcache.hpp"
 #include "types.hpp"
 
 #include <type_traits>
 #include <algorithm>
+#include <memory>
 
 namespace trc {
 
@@ -254,26 +257,52 @@ protected:
 };
 
 struct Version : public VersionBase {
-    PictureFile Pictures;
+private:
+    /* Keeps the sprite data alive for deferred sprite decoding, this must
+     * be declared before `Sprites` and `Types` so that it outlives them. */
+    std::shared_ptr<const void> SpriteBacking;
+
+public:
+    /* Sprites load in the background while the remaining files are parsed,
+     * so they need to be declared first. */
     SpriteFile Sprites;
+    PictureFile Pictures;
     TypeFile Types;
     trc::Icons Icons;
     trc::Fonts Fonts;
 
+    /* Tinted outfits, see Renderer::Options::TintCacheSize */
+    mutable TintCache TintedOutfits;
+
 #ifdef DUMP_ITEMS
     void DumpItems();
 #endif
 
 public:
+    /* If `spriteBacking` is given, sprites are decoded on demand from
+     * `spriteData` rather than up-front, and `spriteBacking` must own the
+     * memory that `spriteData` refers to. This is a lot cheaper when only a
+     * few sprites will be drawn, if at all. */
     Version(const VersionTriplet &triplet,
             const DataReader &pictureData,
             const DataReader &spriteData,
-            const DataReader &typeData);
+            const DataReader &typeData,
+            std::shared_ptr<const void> spriteBacking = nullptr);
 
     const EntityType &GetItem(uint16_t id) const {
         return Types.GetItem(id);
     }
 
+    /* As above, using the type resolved when the object was parsed if there
+     * is one. */
+    const EntityType &GetItem(const Object &object) const {
+        if (object.Type != nullptr) {
+            return *object.Type;
+        }
+
+        return Types.GetItem(object.Id);
+    }
+
     const EntityType &GetOutfit(uint16_t id) const {
         return Types.GetOutfit(id);
     }
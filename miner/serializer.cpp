@@ -179,8 +179,9 @@ NLOHMANN_JSON_SERIALIZE_ENUM(Creature::Direction,
                                      {Creature::Direction::West, "West"},
                              });
 
-template <typename T>
-static json ToJSON(const Version &version, const std::vector<T> &objects) {
+template <typename T, typename Allocator>
+static json ToJSON(const Version &version,
+                   const std::vector<T, Allocator> &objects) {
     std::vector<json> result;
 
     std::transform(
@@ -210,7 +211,7 @@ static json ToJSON(const Version &version, const Object &object) {
         result = json{{"ItemId", object.Id}};
 
         if (object.Id != 0) {
-            const auto &type = version.GetItem(object.Id);
+            const auto &type = version.GetItem(object);
 
             if (version.Protocol.ItemMarks) {
                 result["Mark"] = object.Mark;
@@ -972,13 +973,15 @@ static auto Open(const Settings &settings,
     }
 
     const MemoryFile pictures(dataFolder / "Tibia.pic");
-    const MemoryFile sprites(dataFolder / "Tibia.spr");
+    /* We never draw anything, so there's no need to decode sprites. */
+    auto sprites = std::make_shared<const MemoryFile>(dataFolder / "Tibia.spr");
     const MemoryFile types(dataFolder / "Tibia.dat");
 
     auto version = std::make_unique<Version>(desiredVersion,
                                              pictures.Reader(),
-                                             sprites.Reader(),
-                                             types.Reader());
+                                             sprites->Reader(),
+                                             types.Reader(),
+                                             sprites);
 
     auto [recording, partial] = Recordings::Read(inputFormat,
                                                  reader,
@@ -1003,25 +1006,27 @@ void Serialize(const Settings &settings,
 
     auto frames = std::vector<json>();
 
-    for (const auto &frame : recording->Frames) {
-        Assert(settings.StartTime >= std::chrono::milliseconds::zero() &&
-               settings.EndTime >= std::chrono::milliseconds::zero());
+    Assert(settings.StartTime >= std::chrono::milliseconds::zero() &&
+           settings.EndTime >= std::chrono::milliseconds::zero());
+
+    /* Clip to given bounds. */
+    for (auto it = recording->FindFrame(settings.StartTime);
+         it != recording->Frames.cend();
+         it++) {
+        const auto &frame = *it;
 
-        /* Clip to given bounds. */
-        if (frame.Timestamp < settings.StartTime) {
-            continue;
-        } else if (frame.Timestamp > settings.EndTime) {
+        if (frame.Timestamp > settings.EndTime) {
             break;
         }
 
         auto events = std::vector<json>();
 
         for (const auto &event : frame.Events) {
-            if (settings.SkippedEvents.contains(event->Kind())) {
+            if (settings.SkippedEvents.contains(event.Kind())) {
                 continue;
             }
 
-            events.push_back(ToJSON(*version, *event));
+            events.push_back(ToJSON(*version, event));
         }
 
         if (!events.empty()) {
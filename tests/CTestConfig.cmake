@@ -146,6 +146,27 @@ function(scan_test_corpus)
   endforeach()
 endfunction()
 
+## Checks the SIMD blitting kernels against their scalar counterparts. As
+## these are private to the blitter, the test includes it directly and thus
+## needs the same SIMD flags as the library.
+add_executable(blitter-test "tests/blitter.cpp")
+
+if(TIBIARC_NO_SIMD)
+  target_compile_definitions(blitter-test PRIVATE DISABLE_SIMD)
+elseif(EMSCRIPTEN)
+  target_compile_options(blitter-test PRIVATE -msimd128)
+endif()
+
+add_test(NAME "blitter: tint kernels" COMMAND blitter-test)
+
+## Checks that redrawing the game view incrementally, drawing it from scratch,
+## and drawing every tile without skipping any all look the same, on made-up
+## data. Like the above, this includes the renderer to get at its internals.
+add_executable(renderer-test "tests/renderer.cpp")
+target_link_libraries(renderer-test PRIVATE tibiarc)
+
+add_test(NAME "renderer: incremental redraws" COMMAND renderer-test)
+
 block()
   ## In-tree recordings for quick smoke-testing.
   check_tibia_data("${PROJECT_SOURCE_DIR}/tests/8.40/data")
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2025 "John Högberg"
+ *
+ * This file is part of tibiarc.
+ *
+ * tibiarc is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * tibiarc is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with tibiarc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Checks that the SIMD tinting kernels are bit-identical to the scalar one.
+ *
+ * The kernels are private to the blitter, so we include it wholesale to get
+ * at all of them, rather than just the one the running processor would
+ * pick. */
+#include "../lib/blitter.cpp"
+
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+using namespace trc;
+
+using TintKernel = void (*)(const Pixel *,
+                            const Pixel &,
+                            const Pixel &,
+                            const Pixel &,
+                            const Pixel &,
+                            Pixel *,
+                            int);
+
+struct Kernel {
+    std::string_view Name;
+    TintKernel Tint;
+};
+
+static std::vector<Kernel> GetKernels() {
+    std::vector<Kernel> kernels;
+
+#if defined(BLITTER_SSE2)
+    kernels.push_back({"SSE2", Blitter::TintMaskedSSE2});
+#endif
+
+#if defined(BLITTER_AVX2)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back({"AVX2", Blitter::TintMaskedAVX2});
+    } else {
+        std::cout << "AVX2 not supported, skipping it" << std::endl;
+    }
+#endif
+
+#if defined(BLITTER_SIMD128)
+    kernels.push_back({"SIMD128", Blitter::TintMaskedSIMD128});
+#endif
+
+    return kernels;
+}
+
+/* Sprites are 32x32, and the rows handed to the kernels are at most that
+ * wide. */
+static constexpr int SpriteSize = 32;
+static constexpr int SpriteCount = 16;
+
+/* The widest kernel handles 8 pixels at a time, so this covers every
+ * alignment relative to it. */
+static constexpr int MaxOffset = 8;
+
+/* Decoded sprite pixels as drawn by Canvas::Tint: transparent pixels are
+ * zeroed out and the rest are opaque. Aside from the tint keys, we throw in
+ * colors that differ from them in a single channel to make sure they aren't
+ * mistaken for keys. */
+static std::vector<Pixel> MakeSprite(std::mt19937 &rng) {
+    static const Pixel candidates[] = {
+            Pixel(0xFF, 0xFF, 0x00),
+            Pixel(0xFF, 0x00, 0x00),
+            Pixel(0x00, 0xFF, 0x00),
+            Pixel(0x00, 0x00, 0xFF),
+            Pixel(0xFF, 0xFF, 0x01),
+            Pixel(0xFE, 0x00, 0x00),
+            Pixel(0x00, 0xFF, 0x80),
+            Pixel(0x00, 0x01, 0xFF),
+            Pixel(0xFF, 0xFF, 0xFF),
+            Pixel(0x00, 0x00, 0x00),
+    };
+    std::vector<Pixel> sprite;
+
+    for (int idx = 0; idx < SpriteSize * SpriteSize; idx++) {
+        const unsigned kind = rng() % 16;
+
+        if (kind < 4) {
+            sprite.push_back(Pixel::Transparent());
+        } else if (kind < 14) {
+            sprite.push_back(candidates[kind - 4]);
+        } else {
+            sprite.push_back(Pixel(rng(), rng(), rng()));
+        }
+    }
+
+    return sprite;
+}
+
+/* Whatever happens to be on the canvas, alpha included. */
+static std::vector<Pixel> MakeBackground(std::mt19937 &rng) {
+    std::vector<Pixel> background;
+
+    for (int idx = 0; idx < SpriteSize + MaxOffset; idx++) {
+        background.push_back(Pixel(rng(), rng(), rng(), rng()));
+    }
+
+    return background;
+}
+
+int main() {
+    const std::vector<Kernel> kernels = GetKernels();
+    std::mt19937 rng(1234);
+    std::vector<std::vector<Pixel>> sprites;
+    int failures = 0;
+
+    if (kernels.empty()) {
+        std::cout << "No SIMD kernels to test" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    for (int idx = 0; idx < SpriteCount; idx++) {
+        sprites.push_back(MakeSprite(rng));
+    }
+
+    /* Testing every combination of the four colors is out of the question,
+     * so we'll go through every palette index in each slot while picking the
+     * other three at random. */
+    for (int slot = 0; slot < 4; slot++) {
+        for (int color = 0; color < Pixel::OutfitColorCount; color++) {
+            int indexes[4];
+
+            for (int &index : indexes) {
+                index = rng() % Pixel::OutfitColorCount;
+            }
+
+            indexes[slot] = color;
+
+            const Pixel head = Pixel::OutfitColor(indexes[0]);
+            const Pixel primary = Pixel::OutfitColor(indexes[1]);
+            const Pixel secondary = Pixel::OutfitColor(indexes[2]);
+            const Pixel detail = Pixel::OutfitColor(indexes[3]);
+
+            const auto &sprite = sprites[rng() % sprites.size()];
+
+            for (int row = 0; row < SpriteSize; row++) {
+                const Pixel *source = &sprite[row * SpriteSize];
+                const std::vector<Pixel> background = MakeBackground(rng);
+
+                /* Start anywhere in the row and stop anywhere after that,
+                 * placing the target at an unrelated offset so that loads
+                 * and stores are misaligned differently. */
+                const int begin = rng() % SpriteSize;
+                const int count = rng() % (SpriteSize - begin + 1);
+                const int offset = rng() % MaxOffset;
+
+                std::vector<Pixel> expected = background;
+                Blitter::TintMaskedScalar(&source[begin],
+                                          head,
+                                          primary,
+                                          secondary,
+                                          detail,
+                                          &expected[offset],
+                                          count);
+
+                for (const Kernel &kernel : kernels) {
+                    std::vector<Pixel> actual = background;
+                    kernel.Tint(&source[begin],
+                                head,
+                                primary,
+                                secondary,
+                                detail,
+                                &actual[offset],
+                                count);
+
+                    if (std::memcmp(actual.data(),
+                                    expected.data(),
+                                    expected.size() * sizeof(Pixel))) {
+                        std::cerr << std::format("{}: mismatch for colors "
+                                                 "{}/{}/{}/{}, pixels {}-{} "
+                                                 "of row {} at offset {}",
+                                                 kernel.Name,
+                                                 indexes[0],
+                                                 indexes[1],
+                                                 indexes[2],
+                                                 indexes[3],
+                                                 begin,
+                                                 begin + count,
+                                                 row,
+                                                 offset)
+                                  << std::endl;
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
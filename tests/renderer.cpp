@@ -0,0 +1,1142 @@
+/*
+ * Copyright 2025 "John Högberg"
+ *
+ * This file is part of tibiarc.
+ *
+ * tibiarc is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * tibiarc is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with tibiarc. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Checks that the game view looks the same however it is drawn: redrawing
+ * only what has changed since the last frame through a ViewState, drawing it
+ * from scratch, and drawing every tile of every floor like the renderer did
+ * before it learned to skip empty tiles and tiles hidden beneath opaque
+ * ground.
+ *
+ * The latter needs the internals of the renderer, so we include it wholesale
+ * like the blitter test does. As there are no data files in the tree, we make
+ * up our own in the 7.55 format, and then script our way through the events
+ * that the renderer has to keep up with. */
+#include "../lib/renderer.cpp"
+
+#include "events.hpp"
+#include "gamestate.hpp"
+#include "versions.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace trc;
+
+/* Little-endian, like the data files themselves. */
+struct DataWriter {
+    std::vector<uint8_t> Data;
+
+    void WriteU8(uint8_t value) {
+        Data.push_back(value);
+    }
+
+    void WriteU16(uint16_t value) {
+        WriteU8(value & 0xFF);
+        WriteU8(value >> 8);
+    }
+
+    void WriteU32(uint32_t value) {
+        WriteU16(value & 0xFFFF);
+        WriteU16(value >> 16);
+    }
+
+    void PatchU16(size_t offset, uint16_t value) {
+        Data[offset + 0] = value & 0xFF;
+        Data[offset + 1] = value >> 8;
+    }
+
+    void PatchU32(size_t offset, uint32_t value) {
+        PatchU16(offset + 0, value & 0xFFFF);
+        PatchU16(offset + 2, value >> 16);
+    }
+
+    DataReader Reader() const {
+        return DataReader(Data.size(), Data.data());
+    }
+};
+
+static const VersionTriplet DataVersion{7, 55, 0};
+
+/* Every eighth sprite is empty, and the three after it are fully opaque. The
+ * rest have holes in them, and some of their pixels are tint keys. */
+static constexpr int SpriteCount = 256;
+
+static bool IsOpaqueSprite(int id) {
+    return (id % 8) >= 1 && (id % 8) <= 3;
+}
+
+static void MakeSprites(std::mt19937 &rng, DataWriter &sprites) {
+    static const Pixel colors[] = {Pixel(0xFF, 0xFF, 0x00),
+                                   Pixel(0xFF, 0x00, 0x00),
+                                   Pixel(0x00, 0xFF, 0x00),
+                                   Pixel(0x00, 0x00, 0xFF),
+                                   Pixel(0x80, 0x40, 0x20),
+                                   Pixel(0x20, 0x80, 0x40)};
+
+    sprites.WriteU32(0x55555555);
+    sprites.WriteU16(SpriteCount);
+
+    const size_t indexOffset = sprites.Data.size();
+
+    for (int id = 1; id <= SpriteCount; id++) {
+        sprites.WriteU32(0);
+    }
+
+    for (int id = 1; id <= SpriteCount; id++) {
+        sprites.PatchU32(indexOffset + (id - 1) * 4, sprites.Data.size());
+
+        /* Color key, unused. */
+        sprites.WriteU8(0xFF);
+        sprites.WriteU8(0x00);
+        sprites.WriteU8(0xFF);
+
+        const size_t sizeOffset = sprites.Data.size();
+        sprites.WriteU16(0);
+
+        if ((id % 8) == 0) {
+            continue;
+        }
+
+        const Pixel base(rng(), rng(), rng());
+        int pixel = 0;
+
+        while (pixel < 32 * 32) {
+            int transparent = 0, opaque = 32 * 32;
+
+            if (!IsOpaqueSprite(id)) {
+                transparent = rng() % 40;
+                opaque = rng() % 40;
+            }
+
+            transparent = std::min(transparent, 32 * 32 - pixel);
+            pixel += transparent;
+            opaque = std::min(opaque, 32 * 32 - pixel);
+            pixel += opaque;
+
+            sprites.WriteU16(transparent);
+            sprites.WriteU16(opaque);
+
+            for (int idx = 0; idx < opaque; idx++) {
+                const Pixel &color = (rng() % 4) == 0
+                                             ? colors[rng() % std::size(colors)]
+                                             : base;
+
+                sprites.WriteU8(color.Red);
+                sprites.WriteU8(color.Green);
+                sprites.WriteU8(color.Blue ^ (idx & 0x1F));
+            }
+        }
+
+        sprites.PatchU16(sizeOffset, sprites.Data.size() - sizeOffset - 2);
+    }
+}
+
+/* The game view needs no pictures, so they're all blank. */
+static void MakePictures(DataWriter &pictures) {
+    constexpr int count = 8, width = 16, height = 12;
+
+    pictures.WriteU32(0x55555555);
+    pictures.WriteU16(count);
+
+    const uint32_t blankOffset =
+            pictures.Data.size() + count * (5 + width * height * 4);
+
+    for (int picture = 0; picture < count; picture++) {
+        pictures.WriteU8(width);
+        pictures.WriteU8(height);
+
+        /* Color key, unused. */
+        pictures.WriteU8(0x00);
+        pictures.WriteU8(0x00);
+        pictures.WriteU8(0x00);
+
+        for (int sprite = 0; sprite < width * height; sprite++) {
+            pictures.WriteU32(blankOffset);
+        }
+    }
+
+    pictures.WriteU16(0);
+}
+
+/* Item types by id range, see MakeTypes. */
+enum {
+    OpaqueGroundFirst = 100,
+    GroundFirst = 105,
+    BottomFirst = 110,
+    TopFirst = 120,
+    AnimatedFirst = 130,
+    RedrawNearbyTopFirst = 140,
+    CommonFirst = 145,
+    ItemMax = 179,
+
+    OutfitMax = 5,
+    EffectMax = 16,
+    MissileMax = 4
+};
+
+struct TypeLayout {
+    std::vector<std::pair<TypeProperty, std::vector<uint16_t>>> Properties;
+
+    int SizeX = 1, SizeY = 1;
+    int Layers = 1;
+    int PatternX = 1, PatternY = 1, PatternZ = 1;
+    int Frames = 1;
+
+    bool Opaque = false;
+};
+
+static void WriteType(std::mt19937 &rng,
+                      const std::map<TypeProperty, uint8_t> &properties,
+                      const TypeLayout &layout,
+                      DataWriter &types) {
+    for (const auto &[property, arguments] : layout.Properties) {
+        types.WriteU8(properties.at(property));
+
+        for (uint16_t argument : arguments) {
+            types.WriteU16(argument);
+        }
+    }
+
+    types.WriteU8(0xFF);
+
+    types.WriteU8(layout.SizeX);
+    types.WriteU8(layout.SizeY);
+
+    if (layout.SizeX > 1 || layout.SizeY > 1) {
+        types.WriteU8(64);
+    }
+
+    types.WriteU8(layout.Layers);
+    types.WriteU8(layout.PatternX);
+    types.WriteU8(layout.PatternY);
+    types.WriteU8(layout.PatternZ);
+    types.WriteU8(layout.Frames);
+
+    const int spriteCount = layout.SizeX * layout.SizeY * layout.Layers *
+                            layout.PatternX * layout.PatternY *
+                            layout.PatternZ * layout.Frames;
+
+    for (int idx = 0; idx < spriteCount; idx++) {
+        int id = 1 + rng() % SpriteCount;
+
+        if (layout.Opaque) {
+            id = (id & ~7) + 1 + rng() % 3;
+        }
+
+        types.WriteU16(id);
+    }
+}
+
+static void MakeTypes(std::mt19937 &rng, DataWriter &types) {
+    std::map<TypeProperty, uint8_t> properties;
+    VersionBase base(DataVersion);
+
+    for (int index = 0; index < 0xFF; index++) {
+        try {
+            properties.try_emplace(base.TranslateTypeProperty(index), index);
+        } catch (const InvalidDataError &) {
+            continue;
+        }
+    }
+
+    types.WriteU32(0x55555555);
+    types.WriteU16(ItemMax);
+    types.WriteU16(OutfitMax);
+    types.WriteU16(EffectMax);
+    types.WriteU16(MissileMax);
+
+    for (int id = 100; id <= ItemMax; id++) {
+        TypeLayout layout;
+
+        if (id < BottomFirst) {
+            layout.Properties.push_back({TypeProperty::Ground, {150}});
+            layout.Opaque = id < GroundFirst;
+        } else if (id < TopFirst) {
+            layout.Properties.push_back({TypeProperty::Bottom, {}});
+
+            if (id % 2) {
+                layout.Properties.push_back({TypeProperty::Height, {8}});
+            }
+
+            if (id % 3 == 0) {
+                layout.SizeX = layout.SizeY = 2;
+                layout.Properties.push_back(
+                        {TypeProperty::Displacement, {8, 8}});
+            }
+        } else if (id < AnimatedFirst) {
+            layout.Properties.push_back({TypeProperty::Top, {}});
+            layout.SizeX = 1 + id % 2;
+        } else if (id < RedrawNearbyTopFirst) {
+            layout.Frames = 2 + id % 3;
+
+            if (id % 2) {
+                layout.Properties.push_back({TypeProperty::Bottom, {}});
+            }
+        } else if (id < CommonFirst) {
+            layout.Properties.push_back({TypeProperty::RedrawNearbyTop, {}});
+            layout.SizeY = 2;
+        } else {
+            layout.SizeX = 1 + (id % 4 == 0);
+            layout.SizeY = 1 + (id % 5 == 0);
+
+            if (id % 7 == 0) {
+                layout.Properties.push_back({TypeProperty::Height, {16}});
+            }
+        }
+
+        WriteType(rng, properties, layout, types);
+    }
+
+    for (int id = 1; id <= OutfitMax; id++) {
+        TypeLayout layout;
+
+        layout.PatternX = 4;
+        layout.Frames = 3;
+        layout.Layers = 1 + id % 2;
+        layout.SizeX = layout.SizeY = 1 + (id == 3);
+        layout.Properties.push_back({TypeProperty::Displacement, {8, 8}});
+
+        if (id == 4) {
+            layout.Properties.push_back({TypeProperty::AnimateIdle, {}});
+        }
+
+        WriteType(rng, properties, layout, types);
+    }
+
+    for (int id = 1; id <= EffectMax; id++) {
+        TypeLayout layout;
+
+        layout.Frames = 2 + id % 4;
+        layout.SizeX = layout.SizeY = 1 + (id % 5 == 0);
+
+        WriteType(rng, properties, layout, types);
+    }
+
+    for (int id = 1; id <= MissileMax; id++) {
+        TypeLayout layout;
+
+        layout.PatternX = layout.PatternY = 3;
+
+        WriteType(rng, properties, layout, types);
+    }
+}
+
+static uint32_t Hash(const Position &position) {
+    uint32_t hash = position.X * 0x9E3779B1u ^ position.Y * 0x85EBCA77u ^
+                    position.Z * 0xC2B2AE3Du;
+
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    hash ^= hash >> 12;
+
+    return hash;
+}
+
+/* A made-up world whose map is a fixed function of position, like a real one.
+ * Floors 0 through 4 are empty, 5 and 6 have scattered buildings on them, and
+ * the ground floor as well as those beneath it are covered in ground.
+ *
+ * As the server would, we describe tiles as they come into view, and keep
+ * track of where creatures are in order to include them. */
+struct Scene {
+    static constexpr int FirstCreature = 0x10000000;
+
+    trc::Gamestate Game;
+    std::mt19937 Random;
+    std::map<uint32_t, Position> Creatures;
+
+    /* Whether to describe the tiles that come into view as the player
+     * moves. When not, whatever was left in the tile buffer comes into view
+     * instead. */
+    bool Describe = true;
+
+    Scene(const Version &version, uint32_t seed)
+        : Game(version), Random(seed) {
+        const Position start(100, 100, 7);
+
+        Game.Player.Id = FirstCreature;
+        Game.Map.Position = start;
+
+        for (int idx = 0; idx < 6; idx++) {
+            const uint32_t id = FirstCreature + idx;
+
+            Events::CreatureSeen event;
+            event.CreatureId = id;
+            event.Type = CreatureType::Player;
+            event.Health = 100 - idx * 10;
+            event.Heading = Creature::Direction::South;
+            event.Outfit = {};
+            event.Outfit.Id = 1 + idx % OutfitMax;
+            event.Outfit.HeadColor = idx * 11;
+            event.Outfit.PrimaryColor = idx * 23;
+            event.Outfit.SecondaryColor = idx * 31;
+            event.Outfit.DetailColor = idx * 43;
+            event.LightIntensity = 0;
+            event.LightColor = 0;
+            event.Speed = 220 + idx * 40;
+
+            if (idx == 4) {
+                /* Looks like an animated item. */
+                event.Outfit.Id = 0;
+                event.Outfit.Item.Id = AnimatedFirst;
+            } else if (idx == 5) {
+                /* Invisible. */
+                event.Outfit.Id = 0;
+            }
+
+            event.Update(Game);
+
+            Creatures[id] = idx == 0 ? start
+                                     : Position(start.X - 5 + idx * 2,
+                                                start.Y - 3 + idx % 3 * 3,
+                                                start.Z);
+        }
+
+        DescribeView(Position(0, 0, 0));
+    }
+
+    static void GetVisibleFloors(const Position &center,
+                                 int &top,
+                                 int &bottom) {
+        if (center.Z > 7) {
+            top = center.Z - 2;
+            bottom = std::min(15, center.Z + 2);
+        } else {
+            top = 0;
+            bottom = 7;
+        }
+    }
+
+    static bool IsVisible(const Position &center, const Position &position) {
+        int top, bottom;
+
+        GetVisibleFloors(center, top, bottom);
+
+        const int xyOffset = center.Z - position.Z;
+
+        return position.Z >= top && position.Z <= bottom &&
+               position.X >= center.X - 8 + xyOffset &&
+               position.X <= center.X + 9 + xyOffset &&
+               position.Y >= center.Y - 6 + xyOffset &&
+               position.Y <= center.Y + 7 + xyOffset;
+    }
+
+    void DescribeTile(const Position &position) {
+        const uint32_t hash = Hash(position);
+        Events::TileUpdated event;
+
+        event.Position = position;
+
+        if (position.Z >= 7 || (position.Z >= 5 && (hash % 3) == 0)) {
+            event.Objects.emplace_back(OpaqueGroundFirst + hash % 10);
+
+            for (uint32_t idx = 0; idx < (hash >> 8) % 4; idx++) {
+                event.Objects.emplace_back(RandomItem(hash >> (10 + idx * 5)));
+            }
+        }
+
+        for (const auto &[id, where] : Creatures) {
+            if (where == position) {
+                Object creature(Object::CreatureMarker);
+                creature.CreatureId = id;
+                event.Objects.push_back(creature);
+            }
+        }
+
+        event.Update(Game);
+    }
+
+    /* Describes the tiles that have come into view since the player stood at
+     * `from`. */
+    void DescribeView(const Position &from) {
+        const Position &center = Game.Map.Position;
+        int top, bottom;
+
+        GetVisibleFloors(center, top, bottom);
+
+        for (int z = top; z <= bottom; z++) {
+            const int xyOffset = center.Z - z;
+
+            for (int x = -8; x <= 9; x++) {
+                for (int y = -6; y <= 7; y++) {
+                    const Position position(center.X + x + xyOffset,
+                                            center.Y + y + xyOffset,
+                                            z);
+
+                    if (!IsVisible(from, position)) {
+                        DescribeTile(position);
+                    }
+                }
+            }
+        }
+    }
+
+    /* Anything but grounds, rarely picking items that redraw the tops of
+     * their neighbors. */
+    static uint16_t RandomItem(uint32_t random) {
+        const uint16_t id = BottomFirst + random % (ItemMax - BottomFirst + 1);
+
+        if (id >= RedrawNearbyTopFirst && id < CommonFirst &&
+            (random >> 8) % 4 != 0) {
+            return id + (CommonFirst - RedrawNearbyTopFirst);
+        }
+
+        return id;
+    }
+
+    Position RandomPosition(int z) {
+        const Position &center = Game.Map.Position;
+        const int xyOffset = center.Z - z;
+
+        return Position(center.X - 8 + xyOffset + Random() % 18,
+                        center.Y - 6 + xyOffset + Random() % 14,
+                        z);
+    }
+
+    /* Steps must end on ground, while teleports can go anywhere. */
+    bool CanMove(const Position &from, const Position &to) const {
+        const auto &tile = Game.Map.Tile(to);
+
+        if (tile.ObjectCount >= Tile::MaxObjects - 1) {
+            return false;
+        } else if (tile.ObjectCount == 0 || from.Z != to.Z ||
+                   std::abs(from.X - to.X) > 1 ||
+                   std::abs(from.Y - to.Y) > 1) {
+            return true;
+        }
+
+        return !tile.Objects[0].IsCreature() &&
+               Game.Version.GetItem(tile.Objects[0])
+                               .Properties.StackPriority == 0;
+    }
+
+    void Move(uint32_t id, const Position &to) {
+        const Position from = Creatures.at(id);
+        const auto &tile = Game.Map.Tile(from);
+        Events::CreatureMoved event;
+
+        if (!CanMove(from, to)) {
+            return;
+        }
+
+        event.From = from;
+        event.To = to;
+        event.CreatureId = id;
+        event.StackPosition = Tile::StackPositionTop;
+
+        for (int idx = 0; idx < tile.ObjectCount; idx++) {
+            if (tile.Objects[idx].IsCreature() &&
+                tile.Objects[idx].CreatureId == id) {
+                event.StackPosition = idx;
+            }
+        }
+
+        event.Update(Game);
+        Creatures[id] = to;
+
+        if (id == Game.Player.Id) {
+            Events::PlayerMoved moved;
+
+            moved.Position = to;
+            moved.Update(Game);
+
+            if (Describe) {
+                DescribeView(from);
+            }
+        }
+    }
+
+    bool IsWalking(uint32_t id) const {
+        const auto &movement = Game.GetCreature(id).MovementInformation;
+
+        return movement.WalkEndTick > Game.CurrentTick;
+    }
+
+    /* Lets the other creatures wander around near the player, and makes
+     * things happen around them. */
+    void Bustle() {
+        for (int event = Random() % 4; event > 0; event--) {
+            const int floor =
+                    Game.Map.Position.Z <= 7 ? 5 + Random() % 3
+                                             : Game.Map.Position.Z - 1 +
+                                                       Random() % 3;
+            const Position position = RandomPosition(floor);
+            const auto &tile = Game.Map.Tile(position);
+
+            switch (Random() % 8) {
+            case 0:
+                if (tile.ObjectCount < Tile::MaxObjects - 1) {
+                    Events::TileObjectAdded added;
+                    added.TilePosition = position;
+                    added.StackPosition = Tile::StackPositionTop;
+                    added.Object = Object(RandomItem(Random()));
+                    added.Update(Game);
+                }
+                break;
+            case 1:
+                if (tile.ObjectCount > 1 &&
+                    !tile.Objects[tile.ObjectCount - 1].IsCreature()) {
+                    Events::TileObjectRemoved removed;
+                    removed.TilePosition = position;
+                    removed.StackPosition = tile.ObjectCount - 1;
+                    removed.Update(Game);
+                }
+                break;
+            case 2:
+                if (tile.ObjectCount > 1 && !tile.Objects[1].IsCreature()) {
+                    Events::TileObjectTransformed transformed;
+                    transformed.TilePosition = position;
+                    transformed.StackPosition = 1;
+                    transformed.Object = Object(RandomItem(Random()));
+                    transformed.Update(Game);
+                }
+                break;
+            case 3: {
+                Events::GraphicalEffectPopped popped;
+                popped.Position = position;
+                popped.Id = 1 + Random() % EffectMax;
+                popped.Update(Game);
+                break;
+            }
+            case 4: {
+                Events::MissileFired fired;
+                fired.Origin = position;
+                fired.Target = Position(position.X - 4 + Random() % 9,
+                                        position.Y - 3 + Random() % 7,
+                                        position.Z);
+                fired.Id = 1 + Random() % MissileMax;
+                fired.Update(Game);
+                break;
+            }
+            default: {
+                /* Only the player's floor has room for the others. */
+                const uint32_t id =
+                        FirstCreature + 1 + Random() % (Creatures.size() - 1);
+                const Position &from = Creatures.at(id);
+                const Position &center = Game.Map.Position;
+
+                if (IsWalking(id) || from.Z != center.Z) {
+                    break;
+                }
+
+                const Position to(from.X - 1 + Random() % 3,
+                                  from.Y - 1 + Random() % 3,
+                                  from.Z);
+
+                if (to.X >= center.X - 8 && to.X <= center.X + 9 &&
+                    to.Y >= center.Y - 6 && to.Y <= center.Y + 7 &&
+                    to != center) {
+                    Move(id, to);
+                }
+                break;
+            }
+            }
+        }
+    }
+};
+
+/* Draws every tile of every visible floor, the way the renderer did before it
+ * skipped empty and hidden tiles. */
+static void DrawEveryTile(const Renderer::Options &options,
+                          Gamestate &gamestate,
+                          Canvas &canvas) {
+    Renderer::View view = Renderer::PrepareView(options, gamestate);
+
+    Renderer::UpdateRenderHeights(gamestate, view);
+
+    for (int zIdx = view.BottomFloor; zIdx >= view.TopFloor; zIdx--) {
+        const int xyOffset = gamestate.Map.Position.Z - zIdx;
+        const int offsetX = view.OffsetX - xyOffset * 32;
+        const int offsetY = view.OffsetY - xyOffset * 32;
+
+        for (int xIdx = 0; xIdx <= 17; xIdx++) {
+            for (int yIdx = 0; yIdx <= 13; yIdx++) {
+                Position position(gamestate.Map.Position.X - 8 + xIdx +
+                                          xyOffset,
+                                  gamestate.Map.Position.Y - 6 + yIdx +
+                                          xyOffset,
+                                  zIdx);
+                bool redrawNearbyTop = false;
+
+                Renderer::DrawTile(options,
+                                   gamestate,
+                                   position,
+                                   offsetX,
+                                   offsetY,
+                                   gamestate.CurrentTick,
+                                   &redrawNearbyTop,
+                                   canvas);
+
+                if (redrawNearbyTop) {
+                    if (xIdx > 0) {
+                        position.X--;
+
+                        Renderer::DrawTile(options,
+                                           gamestate,
+                                           position,
+                                           offsetX,
+                                           offsetY,
+                                           gamestate.CurrentTick,
+                                           &redrawNearbyTop,
+                                           canvas);
+                    }
+
+                    if (yIdx > 0) {
+                        position.Y--;
+
+                        Renderer::DrawTile(options,
+                                           gamestate,
+                                           position,
+                                           offsetX,
+                                           offsetY,
+                                           gamestate.CurrentTick,
+                                           &redrawNearbyTop,
+                                           canvas);
+
+                        position.X++;
+
+                        Renderer::DrawTile(options,
+                                           gamestate,
+                                           position,
+                                           offsetX,
+                                           offsetY,
+                                           gamestate.CurrentTick,
+                                           &redrawNearbyTop,
+                                           canvas);
+
+                        position.Y++;
+                    }
+
+                    Renderer::DrawTile(options,
+                                       gamestate,
+                                       position,
+                                       offsetX,
+                                       offsetY,
+                                       gamestate.CurrentTick,
+                                       &redrawNearbyTop,
+                                       canvas);
+                }
+            }
+        }
+    }
+}
+
+/* Counts the frames in which the view wasn't drawn the same in all three
+ * ways, or in which the occupancy of the map didn't match its tiles. */
+class Checker {
+    Renderer::Options Options;
+
+    Canvas Reference;
+    Canvas Complete;
+    Canvas Incremental;
+    Renderer::ViewState View;
+
+    std::string_view Scenario;
+    int Frame = 0;
+
+    int CountDifferences(const Canvas &canvas) const {
+        int count = 0;
+
+        for (int y = 0; y < canvas.Height; y++) {
+            count += std::memcmp(&canvas.GetPixel(0, y),
+                                 &Reference.GetPixel(0, y),
+                                 canvas.Width * sizeof(Pixel)) != 0;
+        }
+
+        return count;
+    }
+
+    int CountMisplacedTiles(const Gamestate &gamestate) const {
+        int count = 0;
+
+        for (int z = 0; z < Map::TileBufferDepth; z++) {
+            const auto &occupancy = gamestate.Map.GetOccupancy(z);
+
+            for (int y = 0; y < Map::TileBufferHeight; y++) {
+                for (int x = 0; x < Map::TileBufferWidth; x++) {
+                    const auto &tile = gamestate.Map.Tile(x, y, z);
+                    bool occupied = tile.ObjectCount > 0, inhabited = false;
+
+                    for (int idx = 0; idx < tile.ObjectCount; idx++) {
+                        inhabited |= tile.Objects[idx].IsCreature();
+                    }
+
+                    for (const auto &effect : tile.GraphicalEffects) {
+                        occupied |= effect.Id != 0;
+                    }
+
+                    count += occupied != ((occupancy.Occupied[y] >> x) & 1);
+                    count += inhabited != ((occupancy.Inhabited[y] >> x) & 1);
+                }
+            }
+        }
+
+        return count;
+    }
+
+    void Report(std::string_view what, int count) {
+        std::cerr << std::format("{}, frame {}: {} {}",
+                                 Scenario,
+                                 Frame,
+                                 count,
+                                 what)
+                  << std::endl;
+        Failures++;
+    }
+
+public:
+    int Failures = 0;
+
+    Checker(std::string_view scenario)
+        : Options{},
+          Reference(Renderer::NativeResolutionX, Renderer::NativeResolutionY),
+          Complete(Renderer::NativeResolutionX, Renderer::NativeResolutionY),
+          Incremental(Renderer::NativeResolutionX,
+                      Renderer::NativeResolutionY),
+          Scenario(scenario) {
+        Options.Width = Renderer::NativeResolutionX;
+        Options.Height = Renderer::NativeResolutionY;
+    }
+
+    void Check(Gamestate &gamestate) {
+        Reference.Fill(Pixel(0, 0, 0), 0, 0, Reference.Width, Reference.Height);
+        Complete.Fill(Pixel(0, 0, 0), 0, 0, Complete.Width, Complete.Height);
+
+        DrawEveryTile(Options, gamestate, Reference);
+        Renderer::DrawGamestate(Options, gamestate, Complete);
+        Renderer::DrawGamestate(Options, gamestate, View, Incremental);
+
+        if (int rows = CountDifferences(Complete)) {
+            Report("rows differ when drawn from scratch", rows);
+        }
+
+        if (int rows = CountDifferences(Incremental)) {
+            Report("rows differ when drawn incrementally", rows);
+        }
+
+        if (int tiles = CountMisplacedTiles(gamestate)) {
+            Report("tiles have the wrong occupancy", tiles);
+        }
+
+        Frame++;
+    }
+};
+
+/* Advances the clock by a frame's worth of time, which varies to catch walks
+ * and animations at different points. */
+static void Play(Scene &scene, Checker &checker, int frames, bool bustle) {
+    for (int frame = 0; frame < frames; frame++) {
+        scene.Game.CurrentTick += 10 + scene.Random() % 50;
+
+        if (bustle) {
+            scene.Bustle();
+        }
+
+        checker.Check(scene.Game);
+    }
+}
+
+static void WalkPlayer(Scene &scene, Checker &checker, int dX, int dY) {
+    const Position &from = scene.Game.Map.Position;
+
+    scene.Move(scene.Game.Player.Id,
+               Position(from.X + dX, from.Y + dY, from.Z));
+
+    while (scene.IsWalking(scene.Game.Player.Id)) {
+        Play(scene, checker, 1, true);
+    }
+}
+
+static void Idle(Scene &scene, Checker &checker) {
+    Play(scene, checker, 100, false);
+}
+
+static void Bustle(Scene &scene, Checker &checker) {
+    Play(scene, checker, 200, true);
+}
+
+/* Steps of a single tile scroll the cached floor layers, whose margin is one
+ * tile wide. */
+static void Walk(Scene &scene, Checker &checker) {
+    for (int step = 0; step < 20; step++) {
+        int dX = 0, dY = 0;
+
+        while (dX == 0 && dY == 0) {
+            dX = -1 + scene.Random() % 3;
+            dY = -1 + scene.Random() % 3;
+        }
+
+        WalkPlayer(scene, checker, dX, dY);
+    }
+}
+
+/* As above, but without describing the tiles that come into view, leaving
+ * the renderer to notice that the contents of the tile buffer have moved. */
+static void WalkBlindly(Scene &scene, Checker &checker) {
+    scene.Describe = false;
+    Walk(scene, checker);
+}
+
+/* Moves further than the margin of the floor layers: teleports, and pushes
+ * that come in quicker than a walk would. */
+static void Teleport(Scene &scene, Checker &checker) {
+    const uint32_t player = scene.Game.Player.Id;
+
+    for (int jump = 0; jump < 10; jump++) {
+        const Position &from = scene.Game.Map.Position;
+        const int distance = 2 + jump % 10;
+
+        scene.Move(player,
+                   Position(from.X + (jump % 2 ? distance : -distance),
+                            from.Y + (jump % 3) - 1,
+                            from.Z));
+        Play(scene, checker, 5, true);
+
+        scene.Move(player, Position(from.X + 1, from.Y, from.Z));
+        Play(scene, checker, 1, true);
+        scene.Move(player, Position(from.X + 1, from.Y + 1, from.Z));
+        Play(scene, checker, 10, true);
+    }
+}
+
+static void ChangeFloors(Scene &scene, Checker &checker) {
+    static const int floors[] = {6, 5, 6, 7, 8, 9, 10, 9, 8, 7, 8, 7};
+    const uint32_t player = scene.Game.Player.Id;
+
+    for (int floor : floors) {
+        const Position &from = scene.Game.Map.Position;
+
+        scene.Move(player, Position(from.X + 1, from.Y, floor));
+        Play(scene, checker, 5, true);
+
+        WalkPlayer(scene, checker, 1, 0);
+        WalkPlayer(scene, checker, 0, -1);
+    }
+}
+
+/* Restores snapshots of the game state both in passing and after moving far
+ * away, including to other floors. */
+static void Restore(Scene &scene, Checker &checker) {
+    for (int round = 0; round < 6; round++) {
+        const Scene snapshot = scene;
+
+        if (round % 2) {
+            WalkPlayer(scene, checker, 1, 1);
+            WalkPlayer(scene, checker, 1, 0);
+        } else {
+            const Position &from = scene.Game.Map.Position;
+
+            scene.Move(scene.Game.Player.Id,
+                       Position(from.X + 7, from.Y - 3, 8 + round % 3));
+            Play(scene, checker, 20, true);
+        }
+
+        scene.Game.Restore(snapshot.Game);
+        scene.Creatures = snapshot.Creatures;
+        Play(scene, checker, 20, true);
+    }
+}
+
+/* Items that redraw the tops of their neighbors at the left and top edges of
+ * the view, with creatures standing and walking next to them, and walking
+ * out of view and back. Walking the player then moves the edges across
+ * them. */
+static void RedrawNearbyTop(Scene &scene, Checker &checker) {
+    const Position center = scene.Game.Map.Position;
+    const int leftX = center.X - 8, topY = center.Y - 6;
+
+    for (int idx = 0; idx < 6; idx++) {
+        const Position position(leftX + idx % 2,
+                                idx < 4 ? topY + 3 + (idx / 2) * 4
+                                        : topY + idx % 2,
+                                center.Z);
+
+        for (uint16_t item : {uint16_t(RedrawNearbyTopFirst + idx % 5),
+                              uint16_t(TopFirst + idx)}) {
+            Events::TileObjectAdded added;
+
+            added.TilePosition = position;
+            added.StackPosition = Tile::StackPositionTop;
+            added.Object = Object(item);
+            added.Update(scene.Game);
+        }
+
+        /* Tops for the items to redraw. */
+        for (const Position &neighbor :
+             {Position(position.X + 1, position.Y, position.Z),
+              Position(position.X, position.Y + 1, position.Z),
+              Position(position.X + 1, position.Y + 1, position.Z)}) {
+            Events::TileObjectAdded added;
+
+            added.TilePosition = neighbor;
+            added.StackPosition = Tile::StackPositionTop;
+            added.Object = Object(TopFirst + (idx + 5) % 10);
+            added.Update(scene.Game);
+        }
+    }
+
+    /* Next to the items, in the top-left corner, and at the right and bottom
+     * edges. The latter are drawn at the opposite edges as well when walking
+     * in from outside the view, as the tile buffer wraps around. */
+    static const std::pair<int, int> spots[] =
+            {{0, 3}, {1, 7}, {0, 0}, {17, 5}, {9, 13}};
+
+    for (uint32_t id = Scene::FirstCreature + 1;
+         id < Scene::FirstCreature + 6;
+         id++) {
+        const auto [x, y] = spots[id - Scene::FirstCreature - 1];
+
+        scene.Move(id, Position(leftX + x, topY + y, center.Z));
+    }
+
+    Play(scene, checker, 5, false);
+
+    for (int round = 0; round < 4; round++) {
+        /* Walk along the edges, out of view, and back. */
+        for (const auto [dX, dY] : {std::pair{0, 1},
+                                    std::pair{-1, 0},
+                                    std::pair{1, 0},
+                                    std::pair{1, 1},
+                                    std::pair{0, -1},
+                                    std::pair{-1, -1},
+                                    std::pair{-1, -1},
+                                    std::pair{1, 1}}) {
+            for (uint32_t id = Scene::FirstCreature + 1;
+                 id < Scene::FirstCreature + 6;
+                 id++) {
+                const Position from = scene.Creatures.at(id);
+
+                scene.Move(id, Position(from.X + dX, from.Y + dY, from.Z));
+            }
+
+            Play(scene, checker, 15, false);
+        }
+
+        /* Move the edges across the items, one tile at a time. */
+        const int direction = (round % 2) ? 1 : -1;
+
+        WalkPlayer(scene, checker, direction, 0);
+        WalkPlayer(scene, checker, 0, direction);
+        WalkPlayer(scene, checker, -direction, -direction);
+        Play(scene, checker, 5, false);
+    }
+}
+
+/* Creatures walking off empty tiles, which are only drawn because of their
+ * neighbors. */
+static void WalkUpstairs(Scene &scene, Checker &checker) {
+    const Position &center = scene.Game.Map.Position;
+
+    scene.Move(scene.Game.Player.Id,
+               Position(center.X + 1, center.Y + 1, center.Z - 1));
+
+    for (uint32_t id = Scene::FirstCreature + 1;
+         id < Scene::FirstCreature + scene.Creatures.size();
+         id++) {
+        scene.Move(id,
+                   Position(center.X - 6 + (id % 5) * 3,
+                            center.Y - 4 + (id % 3) * 3,
+                            center.Z));
+    }
+
+    Play(scene, checker, 300, true);
+}
+
+/* Changes to floors that are empty, and to tiles hidden beneath opaque
+ * ground. */
+static void ChangeHiddenTiles(Scene &scene, Checker &checker) {
+    for (int round = 0; round < 100; round++) {
+        const int floor = 1 + scene.Random() % 7;
+        const Position position = scene.RandomPosition(floor);
+        const auto &tile = scene.Game.Map.Tile(position);
+
+        if (scene.Random() % 2) {
+            Events::TileUpdated updated;
+
+            updated.Position = position;
+
+            if (tile.ObjectCount == 0) {
+                updated.Objects.emplace_back(OpaqueGroundFirst + round % 10);
+                updated.Objects.emplace_back(Scene::RandomItem(round));
+            }
+
+            updated.Update(scene.Game);
+        } else if (tile.ObjectCount < Tile::MaxObjects - 1) {
+            Events::TileObjectAdded added;
+
+            added.TilePosition = position;
+            added.StackPosition = Tile::StackPositionTop;
+            added.Object = Object(Scene::RandomItem(scene.Random()));
+            added.Update(scene.Game);
+        }
+
+        Play(scene, checker, 1, false);
+    }
+}
+
+struct Scenario {
+    std::string_view Name;
+    void (*Run)(Scene &, Checker &);
+};
+
+int main() {
+    static const Scenario scenarios[] = {
+            {"idle", Idle},
+            {"bustle", Bustle},
+            {"walk", Walk},
+            {"walk blindly", WalkBlindly},
+            {"teleport", Teleport},
+            {"change floors", ChangeFloors},
+            {"restore", Restore},
+            {"redraw nearby top", RedrawNearbyTop},
+            {"walk upstairs", WalkUpstairs},
+            {"change hidden tiles", ChangeHiddenTiles},
+    };
+    DataWriter pictures, sprites, types;
+    std::mt19937 rng(1234);
+    int failures = 0;
+
+    MakePictures(pictures);
+    MakeSprites(rng, sprites);
+    MakeTypes(rng, types);
+
+    const Version version(DataVersion,
+                          pictures.Reader(),
+                          sprites.Reader(),
+                          types.Reader());
+
+    for (const Scenario &scenario : scenarios) {
+        Scene scene(version, rng());
+        Checker checker(scenario.Name);
+
+        checker.Check(scene.Game);
+        scenario.Run(scene, checker);
+
+        failures += checker.Failures;
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}